@@ -0,0 +1,50 @@
+#include "BitCount.hpp"
+
+#include "CpuFeatures.hpp"
+
+#include <bit>
+
+namespace sw::core::bits {
+
+	size_t popcountScalar(const uint64_t* words, size_t count) {
+		size_t total = 0;
+		for (size_t i = 0; i < count; ++i)
+			total += static_cast<size_t>(std::popcount(words[i]));
+		return total;
+	}
+
+#if SW_HAS_AVX2_KERNELS
+	// Popcount по таблице полубайтов (алгоритм Мулы): 4 слова за итерацию
+	__attribute__((target("avx2"))) size_t popcountAvx2(const uint64_t* words, size_t count) {
+		const __m256i lookup = _mm256_setr_epi8(
+			0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+			0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+		const __m256i lowNibble = _mm256_set1_epi8(0x0f);
+		__m256i accumulator = _mm256_setzero_si256();
+
+		size_t i = 0;
+		for (; i + 4 <= count; i += 4) {
+			const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(words + i));
+			const __m256i low = _mm256_and_si256(v, lowNibble);
+			const __m256i high = _mm256_and_si256(_mm256_srli_epi16(v, 4), lowNibble);
+			const __m256i bytes = _mm256_add_epi8(_mm256_shuffle_epi8(lookup, low), _mm256_shuffle_epi8(lookup, high));
+			accumulator = _mm256_add_epi64(accumulator, _mm256_sad_epu8(bytes, _mm256_setzero_si256()));
+		}
+
+		alignas(32) uint64_t lanes[4];
+		_mm256_store_si256(reinterpret_cast<__m256i*>(lanes), accumulator);
+		return static_cast<size_t>(lanes[0] + lanes[1] + lanes[2] + lanes[3]) + popcountScalar(words + i, count - i);
+	}
+#else
+	size_t popcountAvx2(const uint64_t* words, size_t count) {
+		return popcountScalar(words, count);
+	}
+#endif
+
+	size_t popcount(const uint64_t* words, size_t count) {
+		// На коротких отрезках векторная версия не окупается
+		if (count >= 8 && cpuHasAvx2())
+			return popcountAvx2(words, count);
+		return popcountScalar(words, count);
+	}
+}
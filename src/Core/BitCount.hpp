@@ -0,0 +1,13 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace sw::core::bits {
+
+	// Суммарное число единичных бит в массиве слов. Скалярная и AVX2-версии дают одинаковый результат;
+	// popcount выбирает AVX2 при поддержке процессором
+	size_t popcountScalar(const uint64_t* words, size_t count);
+	size_t popcountAvx2(const uint64_t* words, size_t count);
+	size_t popcount(const uint64_t* words, size_t count);
+}
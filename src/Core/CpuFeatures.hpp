@@ -0,0 +1,22 @@
+#pragma once
+
+// Векторные ядра собираются через атрибут target("avx2") и выбираются во время выполнения,
+// поэтому сборка не требует флагов -mavx2 и работает на процессорах без AVX2
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+	#define SW_HAS_AVX2_KERNELS 1
+	#include <immintrin.h>
+#else
+	#define SW_HAS_AVX2_KERNELS 0
+#endif
+
+namespace sw::core {
+
+	inline bool cpuHasAvx2() {
+#if SW_HAS_AVX2_KERNELS
+		static const bool supported = __builtin_cpu_supports("avx2");
+		return supported;
+#else
+		return false;
+#endif
+	}
+}
@@ -0,0 +1,104 @@
+#include "DistanceKernel.hpp"
+
+#include "CpuFeatures.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cstdlib>
+
+namespace sw::core::kernels {
+
+	void chebyshevRingScalar(
+		const int32_t* xs,
+		const int32_t* ys,
+		size_t count,
+		const Coord& center,
+		int32_t minD,
+		int32_t maxD,
+		std::vector<uint32_t>& hits)
+	{
+		if (maxD < 0 || minD > maxD)
+			return;
+		const int64_t lo = std::max(minD, 0);
+		const int64_t hi = maxD;
+		for (size_t i = 0; i < count; ++i) {
+			// В 64 битах разность координат не переполняется, в том числе для удаленных слотов
+			const int64_t dx = std::abs(int64_t{xs[i]} - center.x);
+			const int64_t dy = std::abs(int64_t{ys[i]} - center.y);
+			const int64_t distance = std::max(dx, dy);
+			if (distance >= lo && distance <= hi)
+				hits.push_back(static_cast<uint32_t>(i));
+		}
+	}
+
+#if SW_HAS_AVX2_KERNELS
+	// 8 юнитов за итерацию. |a - b| считается как max(a, b) - min(a, b): результат точен как беззнаковое 32-битное,
+	// а беззнаковые сравнения выражены через max_epu32
+	__attribute__((target("avx2"))) void chebyshevRingAvx2(
+		const int32_t* xs,
+		const int32_t* ys,
+		size_t count,
+		const Coord& center,
+		int32_t minD,
+		int32_t maxD,
+		std::vector<uint32_t>& hits)
+	{
+		if (maxD < 0 || minD > maxD)
+			return;
+		const __m256i cx = _mm256_set1_epi32(center.x);
+		const __m256i cy = _mm256_set1_epi32(center.y);
+		const __m256i lo = _mm256_set1_epi32(std::max(minD, 0));
+		const __m256i hi = _mm256_set1_epi32(maxD);
+
+		size_t i = 0;
+		for (; i + 8 <= count; i += 8) {
+			const __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(xs + i));
+			const __m256i y = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(ys + i));
+			const __m256i dx = _mm256_sub_epi32(_mm256_max_epi32(x, cx), _mm256_min_epi32(x, cx));
+			const __m256i dy = _mm256_sub_epi32(_mm256_max_epi32(y, cy), _mm256_min_epi32(y, cy));
+			const __m256i distance = _mm256_max_epu32(dx, dy);
+			const __m256i notBelow = _mm256_cmpeq_epi32(_mm256_max_epu32(distance, lo), distance);
+			const __m256i notAbove = _mm256_cmpeq_epi32(_mm256_max_epu32(distance, hi), hi);
+			const __m256i inRing = _mm256_and_si256(notBelow, notAbove);
+
+			uint32_t mask = static_cast<uint32_t>(_mm256_movemask_ps(_mm256_castsi256_ps(inRing)));
+			while (mask != 0) {
+				hits.push_back(static_cast<uint32_t>(i) + static_cast<uint32_t>(std::countr_zero(mask)));
+				mask &= mask - 1;
+			}
+		}
+
+		const size_t tailStart = hits.size();
+		chebyshevRingScalar(xs + i, ys + i, count - i, center, minD, maxD, hits);
+		for (size_t h = tailStart; h < hits.size(); ++h)
+			hits[h] += static_cast<uint32_t>(i);
+	}
+#else
+	void chebyshevRingAvx2(
+		const int32_t* xs,
+		const int32_t* ys,
+		size_t count,
+		const Coord& center,
+		int32_t minD,
+		int32_t maxD,
+		std::vector<uint32_t>& hits)
+	{
+		chebyshevRingScalar(xs, ys, count, center, minD, maxD, hits);
+	}
+#endif
+
+	void chebyshevRing(
+		const int32_t* xs,
+		const int32_t* ys,
+		size_t count,
+		const Coord& center,
+		int32_t minD,
+		int32_t maxD,
+		std::vector<uint32_t>& hits)
+	{
+		if (cpuHasAvx2())
+			chebyshevRingAvx2(xs, ys, count, center, minD, maxD, hits);
+		else
+			chebyshevRingScalar(xs, ys, count, center, minD, maxD, hits);
+	}
+}
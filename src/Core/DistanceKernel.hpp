@@ -0,0 +1,43 @@
+#pragma once
+
+#include "Coord.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace sw::core::kernels {
+
+	// Координата удаленного слота: расстояние от нее до любой клетки карты не меньше 2^31,
+	// поэтому такой слот не попадает ни в одно кольцо
+	constexpr int32_t kRemovedCoord = INT32_MIN;
+
+	// Дописывает в hits (по возрастанию) индексы i, для которых minD <= chebyshev((xs[i], ys[i]), center) <= maxD.
+	// Скалярная и AVX2-версии дают одинаковый результат; chebyshevRing выбирает AVX2 при поддержке процессором
+	void chebyshevRingScalar(
+		const int32_t* xs,
+		const int32_t* ys,
+		size_t count,
+		const Coord& center,
+		int32_t minD,
+		int32_t maxD,
+		std::vector<uint32_t>& hits);
+
+	void chebyshevRingAvx2(
+		const int32_t* xs,
+		const int32_t* ys,
+		size_t count,
+		const Coord& center,
+		int32_t minD,
+		int32_t maxD,
+		std::vector<uint32_t>& hits);
+
+	void chebyshevRing(
+		const int32_t* xs,
+		const int32_t* ys,
+		size_t count,
+		const Coord& center,
+		int32_t minD,
+		int32_t maxD,
+		std::vector<uint32_t>& hits);
+}
@@ -0,0 +1,248 @@
+#include "GridMap.hpp"
+
+#include "BitCount.hpp"
+
+#include <algorithm>
+#include <bit>
+
+namespace sw::core {
+
+	namespace {
+		// Сколько освобожденных тайлов держим про запас, чтобы юнит, шагающий через границу тайлов,
+		// не выделял и не освобождал память на каждом шаге
+		constexpr size_t kMaxSpareTiles = 16;
+
+		uint64_t lowBits(uint32_t count) {
+			return count >= 64 ? ~uint64_t{0} : (uint64_t{1} << count) - 1;
+		}
+	}
+
+	bool GridMap::anyOccupiedAround(const Coord& center) const {
+		for (int64_t y = int64_t{center.y} - 1; y <= int64_t{center.y} + 1; ++y) {
+			uint64_t bits = rowBits(y, int64_t{center.x} - 1, 3);
+			if (y == center.y)
+				bits &= ~uint64_t{0b010};
+			if (bits)
+				return true;
+		}
+		return false;
+	}
+
+	size_t GridMap::occupiedInRect(const Coord& min, const Coord& max) const {
+		return countInRect(clip(Rect{min.x, min.y, max.x, max.y}));
+	}
+
+	size_t GridMap::occupiedInRing(const Coord& center, int32_t minD, int32_t maxD) const {
+		size_t total = 0;
+		for (const Rect& rect : ringRects(center, minD, maxD))
+			total += countInRect(rect);
+		return total;
+	}
+
+	std::optional<Coord> GridMap::nthOccupiedInRing(const Coord& center, int32_t minD, int32_t maxD, size_t n) const {
+		for (const Rect& rect : ringRects(center, minD, maxD)) {
+			const size_t inRect = countInRect(rect);
+			if (n < inRect)
+				return nthInRect(rect, n);
+			n -= inRect;
+		}
+		return std::nullopt;
+	}
+
+	uint64_t GridMap::rowBits(int64_t y, int64_t x, uint32_t count) const {
+		if (x < 0) {
+			if (x + count <= 0)
+				return 0;
+			const uint32_t skipped = static_cast<uint32_t>(-x);
+			return rowBits(y, 0, count - skipped) << skipped;
+		}
+
+		const int64_t wordX = x >> kTileShift;
+		const uint32_t shift = static_cast<uint32_t>(x) & (kTileSize - 1);
+		uint64_t result = rowWord(y, wordX) >> shift;
+		if (shift != 0 && shift + count > 64)
+			result |= rowWord(y, wordX + 1) << (64 - shift);
+		return result & lowBits(count);
+	}
+
+	void GridMap::updateCell(const Coord& coordinate, int32_t value) {
+		const uint32_t tx = static_cast<uint32_t>(coordinate.x) >> kTileShift;
+		const uint32_t ty = static_cast<uint32_t>(coordinate.y) >> kTileShift;
+		const bool nowOccupied = value != kEmptyCell;
+
+		uint32_t handle = _directory.get(tx, ty);
+		if (handle == 0) {
+			if (!nowOccupied)
+				return;
+			uint32_t slot = 0;
+			if (!_freeTiles.empty()) {
+				slot = _freeTiles.back();
+				_freeTiles.pop_back();
+				if (_tiles[slot])
+					--_spareTiles;
+				else
+					_tiles[slot] = std::make_unique<Tile>();
+			} else {
+				slot = static_cast<uint32_t>(_tiles.size());
+				_tiles.push_back(std::make_unique<Tile>());
+			}
+			handle = slot + 1;
+			_directory.set(tx, ty, handle);
+		}
+
+		Tile& tile = *_tiles[handle - 1];
+		int32_t& cell = tile.cells[cellIndex(coordinate)];
+		const bool wasOccupied = cell != kEmptyCell;
+		cell = value;
+		if (wasOccupied == nowOccupied)
+			return;
+
+		const uint64_t bit = uint64_t{1} << localX(coordinate);
+		uint64_t& row = tile.rows[localY(coordinate)];
+		if (nowOccupied) {
+			row |= bit;
+			++tile.count;
+		} else {
+			row &= ~bit;
+			--tile.count;
+		}
+		_occupancy.add(tx, ty, nowOccupied ? 1 : -1);
+
+		// Пустой тайл возвращаем: все его клетки уже kEmptyCell, а биты нулевые
+		if (tile.count == 0) {
+			if (_spareTiles < kMaxSpareTiles)
+				++_spareTiles;
+			else
+				_tiles[handle - 1].reset();
+			_freeTiles.push_back(handle - 1);
+			_directory.set(tx, ty, 0);
+		}
+	}
+
+	GridMap::Rect GridMap::clip(Rect rect) const {
+		rect.x0 = std::max<int64_t>(rect.x0, 0);
+		rect.y0 = std::max<int64_t>(rect.y0, 0);
+		rect.x1 = std::min<int64_t>(rect.x1, static_cast<int64_t>(_width) - 1);
+		rect.y1 = std::min<int64_t>(rect.y1, static_cast<int64_t>(_height) - 1);
+		return rect;
+	}
+
+	// Кольцо = внешний квадрат минус внутренний: полосы сверху и снизу и два бока между ними
+	std::array<GridMap::Rect, 4> GridMap::ringRects(const Coord& center, int32_t minD, int32_t maxD) const {
+		std::array<Rect, 4> rects{};
+		if (maxD < 0 || minD > maxD)
+			return rects;
+
+		const int64_t cx = center.x;
+		const int64_t cy = center.y;
+		const Rect outer{cx - maxD, cy - maxD, cx + maxD, cy + maxD};
+		if (minD <= 0) {
+			rects[0] = clip(outer);
+			return rects;
+		}
+
+		const Rect inner{cx - (minD - 1), cy - (minD - 1), cx + (minD - 1), cy + (minD - 1)};
+		rects[0] = clip(Rect{outer.x0, outer.y0, outer.x1, inner.y0 - 1});
+		rects[1] = clip(Rect{outer.x0, inner.y1 + 1, outer.x1, outer.y1});
+		rects[2] = clip(Rect{outer.x0, inner.y0, inner.x0 - 1, inner.y1});
+		rects[3] = clip(Rect{inner.x1 + 1, inner.y0, outer.x1, inner.y1});
+		return rects;
+	}
+
+	// Тайлы, целиком покрытые прямоугольником, считаются деревом Фенвика,
+	// остальные (по краям прямоугольника) — маскированным popcount по строкам тайла
+	size_t GridMap::countInRect(const Rect& rect) const {
+		if (rect.empty())
+			return 0;
+
+		const int64_t tx0 = rect.x0 >> kTileShift;
+		const int64_t ty0 = rect.y0 >> kTileShift;
+		const int64_t tx1 = rect.x1 >> kTileShift;
+		const int64_t ty1 = rect.y1 >> kTileShift;
+
+		// Тайл у края карты покрыт целиком, если покрыты все его клетки внутри карты
+		auto coveredX = [&](int64_t tx) {
+			return rect.x0 <= (tx << kTileShift) && rect.x1 >= std::min<int64_t>((tx << kTileShift) + kTileSize - 1, _width - 1);
+		};
+		auto coveredY = [&](int64_t ty) {
+			return rect.y0 <= (ty << kTileShift) && rect.y1 >= std::min<int64_t>((ty << kTileShift) + kTileSize - 1, _height - 1);
+		};
+		const int64_t fx0 = coveredX(tx0) ? tx0 : tx0 + 1;
+		const int64_t fx1 = coveredX(tx1) ? tx1 : tx1 - 1;
+		const int64_t fy0 = coveredY(ty0) ? ty0 : ty0 + 1;
+		const int64_t fy1 = coveredY(ty1) ? ty1 : ty1 - 1;
+
+		size_t total = _occupancy.count(fx0, fy0, fx1, fy1);
+		for (int64_t ty = ty0; ty <= ty1; ++ty) {
+			if (ty < fy0 || ty > fy1 || fx0 > fx1) {
+				for (int64_t tx = tx0; tx <= tx1; ++tx)
+					total += countInTile(tx, ty, rect);
+				continue;
+			}
+			for (int64_t tx = tx0; tx < fx0; ++tx)
+				total += countInTile(tx, ty, rect);
+			for (int64_t tx = fx1 + 1; tx <= tx1; ++tx)
+				total += countInTile(tx, ty, rect);
+		}
+		return total;
+	}
+
+	size_t GridMap::countInTile(int64_t tx, int64_t ty, const Rect& rect) const {
+		const Tile* tile = tileAt(tx, ty);
+		if (!tile)
+			return 0;
+
+		const int64_t originX = tx << kTileShift;
+		const int64_t originY = ty << kTileShift;
+		const int64_t lx0 = std::max(rect.x0, originX) - originX;
+		const int64_t lx1 = std::min(rect.x1, originX + kTileSize - 1) - originX;
+		const int64_t ly0 = std::max(rect.y0, originY) - originY;
+		const int64_t ly1 = std::min(rect.y1, originY + kTileSize - 1) - originY;
+		if (lx0 > lx1 || ly0 > ly1)
+			return 0;
+		if (lx0 == 0 && ly0 == 0 && lx1 == kTileSize - 1 && ly1 == kTileSize - 1)
+			return tile->count;
+
+		const size_t rowCount = static_cast<size_t>(ly1 - ly0 + 1);
+		const uint64_t mask = lowBits(static_cast<uint32_t>(lx1 - lx0 + 1)) << lx0;
+		if (mask == ~uint64_t{0})
+			return bits::popcount(tile->rows.data() + ly0, rowCount);
+
+		size_t total = 0;
+		for (int64_t ly = ly0; ly <= ly1; ++ly)
+			total += static_cast<size_t>(std::popcount(tile->rows[static_cast<size_t>(ly)] & mask));
+		return total;
+	}
+
+	// Бинарный поиск строки, в которой набирается n + 1 занятых клеток, затем проход по словам этой строки
+	Coord GridMap::nthInRect(const Rect& rect, size_t n) const {
+		int64_t lo = rect.y0;
+		int64_t hi = rect.y1;
+		while (lo < hi) {
+			const int64_t mid = lo + (hi - lo) / 2;
+			if (countInRect(Rect{rect.x0, rect.y0, rect.x1, mid}) > n)
+				hi = mid;
+			else
+				lo = mid + 1;
+		}
+		const int64_t y = lo;
+		n -= countInRect(Rect{rect.x0, rect.y0, rect.x1, y - 1});
+
+		for (int64_t wordX = rect.x0 >> kTileShift; wordX <= (rect.x1 >> kTileShift); ++wordX) {
+			const int64_t wordStart = wordX << kTileShift;
+			const int64_t from = std::max(rect.x0, wordStart) - wordStart;
+			const int64_t to = std::min(rect.x1, wordStart + kTileSize - 1) - wordStart;
+			uint64_t word = rowWord(y, wordX) & (lowBits(static_cast<uint32_t>(to - from + 1)) << from);
+
+			const size_t inWord = static_cast<size_t>(std::popcount(word));
+			if (n >= inWord) {
+				n -= inWord;
+				continue;
+			}
+			for (; n > 0; --n)
+				word &= word - 1;
+			return Coord{static_cast<int32_t>(wordStart + std::countr_zero(word)), static_cast<int32_t>(y)};
+		}
+		return Coord{static_cast<int32_t>(rect.x0), static_cast<int32_t>(y)};
+	}
+}
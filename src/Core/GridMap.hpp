@@ -1,19 +1,46 @@
 #pragma once
 
 #include "Coord.hpp"
+#include "GridStore.hpp"
+#include "OccupancyIndex.hpp"
 
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
 #include <cstdint>
+#include <memory>
+#include <optional>
 #include <stdexcept>
 #include <vector>
 
 namespace sw::core {
 
+	// Порядок клеток внутри тайла.
+	// RowMajor — построчно; Morton — Z-порядок, в котором окрестность 3x3 чаще попадает в одну-две кеш-линии.
+	// Тайл (16 КБ) и так почти целиком помещается в L1, поэтому по умолчанию RowMajor: индекс дешевле.
+	// Выбирается в CLI (--cell-layout) или SimulationRunner::setCellLayout; сравнение — цель sw_cell_layout_bench
+	enum class CellLayout {
+		RowMajor,
+		Morton,
+	};
+
+	// Разреженная карта из тайлов kTileSize x kTileSize.
+	// Тайл выделяется при первом занятии клетки в нем и освобождается, когда в нем не остается юнитов,
+	// поэтому память зависит от занятой площади, а не от размеров карты
 	class GridMap {
 	public:
-		GridMap(uint32_t width, uint32_t height)
+		static constexpr int32_t kTileShift = 6;
+		static constexpr int32_t kTileSize = 1 << kTileShift;
+
+		GridMap(uint32_t width, uint32_t height, CellLayout layout = CellLayout::RowMajor)
 			: _width(width)
 			, _height(height)
-			, _cells(static_cast<size_t>(width) * static_cast<size_t>(height), kEmptyCell)
+			, _layout(layout)
+			, _tilesX(tilesFor(width))
+			, _tilesY(tilesFor(height))
+			, _directory(_tilesX, _tilesY)
+			, _occupancy(_tilesX, _tilesY)
 		{
 			if (width == 0 || height == 0) {
 				throw std::runtime_error("Map size must be positive");
@@ -28,46 +55,188 @@ namespace sw::core {
 			return _height;
 		}
 
+		CellLayout layout() const {
+			return _layout;
+		}
+
 		bool inBounds(const Coord& coordinate) const {
 			return coordinate.x >= 0 && coordinate.y >= 0 && static_cast<uint32_t>(coordinate.x) < _width && static_cast<uint32_t>(coordinate.y) < _height;
 		}
 
 		bool isOccupied(const Coord& coordinate) const {
-			return occupantId(coordinate) != kEmptyCell;
+			if (!inBounds(coordinate)) {
+				return false;
+			}
+			const Tile* tile = tileAt(coordinate);
+			return tile && ((tile->rows[localY(coordinate)] >> localX(coordinate)) & 1u);
 		}
 
 		int32_t occupantId(const Coord& coordinate) const {
 			if (!inBounds(coordinate)) {
 				return kEmptyCell;
 			}
-			return _cells[indexOf(coordinate)];
+			const Tile* tile = tileAt(coordinate);
+			return tile ? tile->cells[cellIndex(coordinate)] : kEmptyCell;
 		}
 
 		void setOccupied(const Coord& coordinate, int32_t unitId) {
 			if (!inBounds(coordinate)) {
 				throw std::runtime_error("Coord out of bounds");
 			}
-			_cells[indexOf(coordinate)] = unitId;
+			updateCell(coordinate, unitId);
 		}
 
 		void clear(const Coord& coordinate) {
 			if (!inBounds(coordinate)) {
 				return;
 			}
-			_cells[indexOf(coordinate)] = kEmptyCell;
+			updateCell(coordinate, kEmptyCell);
+		}
+
+		// Занята ли хотя бы одна из 8 соседних клеток
+		bool anyOccupiedAround(const Coord& center) const;
+
+		// Количество занятых клеток в прямоугольнике [min, max] (границы включительно, обрезаются по карте)
+		size_t occupiedInRect(const Coord& min, const Coord& max) const;
+
+		// Количество занятых клеток на расстоянии Чебышева [minD, maxD] от center
+		size_t occupiedInRing(const Coord& center, int32_t minD, int32_t maxD) const;
+
+		// n-я (с нуля) занятая клетка кольца. Порядок обхода фиксирован, но не совпадает с построчным
+		std::optional<Coord> nthOccupiedInRing(const Coord& center, int32_t minD, int32_t maxD, size_t n) const;
+
+		// Обход занятых клеток прямоугольника [min, max] (обрезается по карте): f(Coord, occupantId).
+		// Пустые тайлы пропускаются целиком, внутри тайла перебираются только установленные биты строк
+		template <class F>
+		void forEachOccupiedInRect(const Coord& min, const Coord& max, F&& f) const {
+			const Rect rect = clip(Rect{min.x, min.y, max.x, max.y});
+			if (rect.empty())
+				return;
+			for (int64_t ty = rect.y0 >> kTileShift; ty <= (rect.y1 >> kTileShift); ++ty) {
+				for (int64_t tx = rect.x0 >> kTileShift; tx <= (rect.x1 >> kTileShift); ++tx) {
+					const Tile* tile = tileAt(tx, ty);
+					if (!tile)
+						continue;
+					const int64_t originX = tx << kTileShift;
+					const int64_t originY = ty << kTileShift;
+					const int64_t lx0 = std::max(rect.x0, originX) - originX;
+					const int64_t lx1 = std::min(rect.x1, originX + kTileSize - 1) - originX;
+					const int64_t ly0 = std::max(rect.y0, originY) - originY;
+					const int64_t ly1 = std::min(rect.y1, originY + kTileSize - 1) - originY;
+					const uint64_t mask = (lx1 - lx0 == kTileSize - 1 ? ~uint64_t{0} : ((uint64_t{1} << (lx1 - lx0 + 1)) - 1)) << lx0;
+					for (int64_t ly = ly0; ly <= ly1; ++ly) {
+						for (uint64_t bits = tile->rows[static_cast<size_t>(ly)] & mask; bits != 0; bits &= bits - 1) {
+							const Coord cell{
+								static_cast<int32_t>(originX + std::countr_zero(bits)),
+								static_cast<int32_t>(originY + ly),
+							};
+							f(cell, tile->cells[cellIndex(cell)]);
+						}
+					}
+				}
+			}
+		}
+
+		// Количество выделенных тайлов (для диагностики расхода памяти)
+		size_t allocatedTiles() const {
+			return _tiles.size() - _freeTiles.size() + _spareTiles;
 		}
 
 		// Константа для пустой клетки
 		static constexpr int32_t kEmptyCell = -1;
 
 	private:
-		size_t indexOf(const Coord& c) const {
-			return static_cast<size_t>(c.y) * static_cast<size_t>(_width) + static_cast<size_t>(c.x);
+		struct Tile {
+			Tile() {
+				cells.fill(kEmptyCell);
+			}
+
+			std::array<int32_t, kTileSize * kTileSize> cells;
+			// Бит x слова rows[y] — занятость клетки (x, y) тайла
+			std::array<uint64_t, kTileSize> rows{};
+			uint32_t count{};
+		};
+
+		// Прямоугольник с включительными границами; пустой, если x0 > x1 или y0 > y1
+		struct Rect {
+			int64_t x0{};
+			int64_t y0{};
+			int64_t x1{-1};
+			int64_t y1{-1};
+
+			bool empty() const {
+				return x0 > x1 || y0 > y1;
+			}
+		};
+
+		static uint32_t tilesFor(uint32_t cells) {
+			return static_cast<uint32_t>((static_cast<uint64_t>(cells) + kTileSize - 1) >> kTileShift);
+		}
+
+		static size_t localX(const Coord& c) {
+			return static_cast<size_t>(c.x) & (kTileSize - 1);
+		}
+
+		static size_t localY(const Coord& c) {
+			return static_cast<size_t>(c.y) & (kTileSize - 1);
+		}
+
+		// Биты v, разнесенные по четным разрядам: 0b111 -> 0b10101
+		static constexpr std::array<uint16_t, kTileSize> kMortonSpread = [] {
+			std::array<uint16_t, kTileSize> spread{};
+			for (uint32_t v = 0; v < kTileSize; ++v) {
+				for (uint32_t bit = 0; bit < kTileShift; ++bit)
+					spread[v] |= static_cast<uint16_t>(((v >> bit) & 1u) << (2 * bit));
+			}
+			return spread;
+		}();
+
+		// Индекс клетки в Tile::cells с учетом выбранного порядка
+		size_t cellIndex(const Coord& c) const {
+			if (_layout == CellLayout::Morton)
+				return kMortonSpread[localX(c)] | (static_cast<size_t>(kMortonSpread[localY(c)]) << 1);
+			return (localY(c) << kTileShift) | localX(c);
 		}
 
+		const Tile* tileAt(int64_t tx, int64_t ty) const {
+			const uint32_t handle = _directory.get(static_cast<uint32_t>(tx), static_cast<uint32_t>(ty));
+			return handle == 0 ? nullptr : _tiles[handle - 1].get();
+		}
+
+		const Tile* tileAt(const Coord& c) const {
+			return tileAt(c.x >> kTileShift, c.y >> kTileShift);
+		}
+
+		// Слово занятости клеток [64 * wordX, 64 * wordX + 63] строки y; вне карты — 0
+		uint64_t rowWord(int64_t y, int64_t wordX) const {
+			if (y < 0 || y >= _height || wordX < 0 || wordX >= _tilesX)
+				return 0;
+			const Tile* tile = tileAt(wordX, y >> kTileShift);
+			return tile ? tile->rows[static_cast<size_t>(y) & (kTileSize - 1)] : 0;
+		}
+
+		// Биты клеток [x, x + count) строки y в младших разрядах, count <= 64
+		uint64_t rowBits(int64_t y, int64_t x, uint32_t count) const;
+
+		void updateCell(const Coord& coordinate, int32_t value);
+
+		Rect clip(Rect rect) const;
+		std::array<Rect, 4> ringRects(const Coord& center, int32_t minD, int32_t maxD) const;
+		size_t countInRect(const Rect& rect) const;
+		size_t countInTile(int64_t tx, int64_t ty, const Rect& rect) const;
+		Coord nthInRect(const Rect& rect, size_t n) const;
+
 		uint32_t _width{};
 		uint32_t _height{};
-		std::vector<int32_t> _cells;
+		CellLayout _layout{};
+		uint32_t _tilesX{};
+		uint32_t _tilesY{};
+		// Номер тайла в _tiles плюс один; 0 — тайл не выделен
+		GridStore<uint32_t> _directory;
+		std::vector<std::unique_ptr<Tile>> _tiles;
+		std::vector<uint32_t> _freeTiles;
+		// Освобожденные, но не удаленные тайлы из _freeTiles
+		size_t _spareTiles{};
+		OccupancyIndex _occupancy;
 	};
 }
-
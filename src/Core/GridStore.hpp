@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace sw::core {
+
+	// Значения по клеткам двумерной сетки: плотный массив для небольших сеток и хеш-таблица для огромных.
+	// Значение по умолчанию T{} означает "ничего нет" и в хеш-таблице не хранится
+	template <class T>
+	class GridStore {
+	public:
+		// Больше этого числа клеток плотный массив не выделяется
+		static constexpr uint64_t kMaxDenseCells = uint64_t{1} << 24;
+
+		GridStore(uint32_t width, uint32_t height)
+			: _width(width)
+			, _dense(static_cast<uint64_t>(width) * height <= kMaxDenseCells)
+		{
+			if (_dense)
+				_values.assign(static_cast<size_t>(width) * height, T{});
+		}
+
+		T get(uint32_t x, uint32_t y) const {
+			if (_dense)
+				return _values[static_cast<size_t>(y) * _width + x];
+			auto it = _sparse.find(keyOf(x, y));
+			return it == _sparse.end() ? T{} : it->second;
+		}
+
+		void set(uint32_t x, uint32_t y, T value) {
+			if (_dense) {
+				_values[static_cast<size_t>(y) * _width + x] = value;
+				return;
+			}
+			if (value == T{})
+				_sparse.erase(keyOf(x, y));
+			else
+				_sparse[keyOf(x, y)] = value;
+		}
+
+	private:
+		static uint64_t keyOf(uint32_t x, uint32_t y) {
+			return (static_cast<uint64_t>(y) << 32) | x;
+		}
+
+		uint32_t _width{};
+		bool _dense{};
+		std::vector<T> _values;
+		std::unordered_map<uint64_t, T> _sparse;
+	};
+}
@@ -1,15 +1,63 @@
 #pragma once
 
+#include "Coord.hpp"
+#include "Perception.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
 namespace sw::core {
 
+	class GridMap;
 	class Unit;
 	struct TurnContext;
 
+	// Свойства поведения, по которым движок решает, что можно не выполнять. Не меняются за время его жизни
+	struct BehaviorTraits {
+		// От чего зависит результат tryAct
+		enum class Locality {
+			// Только от окрестности perception: юнит засыпает, пока в ней ничего не меняется
+			Neighbourhood,
+			// То же, но во время марша — от всей карты (путь)
+			NeighbourhoodUnlessMarching,
+			// Не только от окрестности: юнит не засыпает
+			Global,
+		};
+
+		// Окрестность, которую tryAct читает из TurnContext::perception. Движок собирает ее один раз за ход юнита
+		// по объединению потребностей всех его поведений; ее радиус (не меньше 0) — радиус сна юнита
+		PerceptionNeeds perception;
+		Locality locality = Locality::Global;
+		// Поведение может действовать, только если другой юнит находится на расстоянии Чебышева не больше reach.
+		// std::nullopt — действует независимо от других юнитов. В ходах, где заведомо ни у кого нет такого соседа,
+		// движок вызывает только независимые поведения (см. World::isQuietTurn)
+		std::optional<int32_t> interactionReach;
+		// Наибольшее смещение юнита этим поведением за ход. std::nullopt — неизвестно, ходы не пропускаются
+		std::optional<int32_t> maxStepPerTurn;
+	};
+
 	class IBehavior {
 	public:
 		virtual ~IBehavior() = default;
 
 		// Возвращает true, если поведение выполнило действие в этом ходу, false в противном случае.
 		virtual bool tryAct(Unit& self, TurnContext& ctx) = 0;
+
+		// Что поведение читает и как далеко действует; вызывается один раз при добавлении к юниту
+		virtual BehaviorTraits traits() const {
+			return {};
+		}
+
+		// Клетки, которые юнит пройдет в следующих ходах, если рядом никого не будет: дописывает в cells
+		// не больше maxCells клеток в порядке прохождения, по BehaviorTraits::maxStepPerTurn за ход. Последняя клетка плана,
+		// совпадающая с целью марша, заканчивает марш. false — план неизвестен, ходы не пропускаются (World::planMarchSkip)
+		virtual bool planMarch(const Unit&, const GridMap&, size_t, std::vector<Coord>&) const {
+			return false;
+		}
+
+		// Юнит прошел steps первых клеток плана без вызовов tryAct
+		virtual void skipMarchSteps(size_t) {}
 	};
 }
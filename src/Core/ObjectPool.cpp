@@ -0,0 +1,31 @@
+#include "ObjectPool.hpp"
+
+namespace sw::core {
+
+	void* ObjectPool::allocate(size_t size) {
+		const size_t sizeClassIndex = sizeClass(size);
+		if (FreeBlock* block = _free[sizeClassIndex]) {
+			_free[sizeClassIndex] = block->next;
+			return block;
+		}
+
+		const size_t blockBytes = sizeClassIndex * kAlignment;
+		if (static_cast<size_t>(_end - _cursor) < blockBytes) {
+			// Хвост прежней пластины пропадает: он меньше kMaxPooledSize
+			size_t slabBytes = kFirstSlabBytes;
+			for (size_t i = 0; i < _slabs.size() && slabBytes < kMaxSlabBytes; ++i)
+				slabBytes *= 2;
+			_slabs.push_back(std::make_unique_for_overwrite<std::byte[]>(slabBytes));
+			_cursor = _slabs.back().get();
+			_end = _cursor + slabBytes;
+		}
+		void* block = _cursor;
+		_cursor += blockBytes;
+		return block;
+	}
+
+	void ObjectPool::deallocate(void* block, size_t size) {
+		const size_t sizeClassIndex = sizeClass(size);
+		_free[sizeClassIndex] = ::new (block) FreeBlock{_free[sizeClassIndex]};
+	}
+}
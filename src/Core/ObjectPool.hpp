@@ -0,0 +1,106 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace sw::core {
+
+	class ObjectPool;
+
+	// Удаляет объект, созданный ObjectPool::make, и возвращает его блок в пул; без пула — обычный delete
+	struct PoolDeleter {
+		ObjectPool* pool = nullptr;
+		// Размер блока динамического типа: PoolPtr<Derived> преобразуется в PoolPtr<Base> вместе с удалителем
+		uint32_t size = 0;
+
+		template <class T>
+		void operator()(T* object) const;
+	};
+
+	template <class T>
+	using PoolPtr = std::unique_ptr<T, PoolDeleter>;
+
+	// Объект, созданный обычным new (например, поведение, добавленное фичей через make_unique)
+	template <class T>
+	PoolPtr<T> adoptHeapObject(std::unique_ptr<T> object) {
+		return PoolPtr<T>(object.release());
+	}
+
+	// Пул небольших объектов (юниты, их поведения). Блоки нарезаются подряд из пластин, поэтому юнит и его поведения,
+	// созданные друг за другом, лежат рядом, а юниты идут в порядке создания. Первая пластина — kFirstSlabBytes,
+	// каждая следующая вдвое больше, но не больше kMaxSlabBytes: небольшой бой (а их в одном процессе могут быть
+	// тысячи) занимает единицы КБ, а крупный выделяет память редко.
+	// Освобожденный блок попадает в список свободных блоков своего размера и отдается следующему make.
+	// Не потокобезопасен: пулом владеет World и пользуется им из одного потока
+	class ObjectPool {
+	public:
+		static constexpr size_t kAlignment = __STDCPP_DEFAULT_NEW_ALIGNMENT__;
+		static constexpr size_t kMaxPooledSize = 256;
+		static constexpr size_t kFirstSlabBytes = 1024;
+		static constexpr size_t kMaxSlabBytes = 64 * 1024;
+
+		ObjectPool() = default;
+
+		ObjectPool(const ObjectPool&) = delete;
+		ObjectPool& operator=(const ObjectPool&) = delete;
+
+		// Объекты больше kMaxPooledSize или с большим выравниванием создаются обычным new
+		template <class T, class... TArgs>
+		PoolPtr<T> make(TArgs&&... args) {
+			if constexpr (sizeof(T) > kMaxPooledSize || alignof(T) > kAlignment) {
+				return PoolPtr<T>(new T(std::forward<TArgs>(args)...));
+			} else {
+				void* storage = allocate(sizeof(T));
+				try {
+					return PoolPtr<T>(::new (storage) T(std::forward<TArgs>(args)...), PoolDeleter{this, static_cast<uint32_t>(sizeof(T))});
+				} catch (...) {
+					deallocate(storage, sizeof(T));
+					throw;
+				}
+			}
+		}
+
+		void* allocate(size_t size);
+		void deallocate(void* block, size_t size);
+
+		// Выделенные пластины (для диагностики расхода памяти)
+		size_t slabCount() const {
+			return _slabs.size();
+		}
+
+	private:
+		struct FreeBlock {
+			FreeBlock* next;
+		};
+
+		static size_t sizeClass(size_t size) {
+			return (size + kAlignment - 1) / kAlignment;
+		}
+
+		std::array<FreeBlock*, kMaxPooledSize / kAlignment + 1> _free{};
+		std::vector<std::unique_ptr<std::byte[]>> _slabs;
+		std::byte* _cursor = nullptr;
+		std::byte* _end = nullptr;
+	};
+
+	template <class T>
+	void PoolDeleter::operator()(T* object) const {
+		if (!pool) {
+			delete object;
+			return;
+		}
+		void* storage = nullptr;
+		if constexpr (std::is_polymorphic_v<T>)
+			storage = dynamic_cast<void*>(object);
+		else
+			storage = object;
+		object->~T();
+		pool->deallocate(storage, size);
+	}
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include "GridStore.hpp"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace sw::core {
+
+	// Двумерное дерево Фенвика над количеством занятых клеток в тайлах карты.
+	// Считает занятые клетки в прямоугольнике из целых тайлов за O(log TX * log TY)
+	class OccupancyIndex {
+	public:
+		OccupancyIndex(uint32_t tilesX, uint32_t tilesY)
+			: _tilesX(tilesX)
+			, _tilesY(tilesY)
+			, _tree(tilesX, tilesY)
+		{}
+
+		void add(uint32_t tx, uint32_t ty, int32_t delta) {
+			for (uint32_t i = ty + 1; i <= _tilesY; i += i & (~i + 1)) {
+				for (uint32_t j = tx + 1; j <= _tilesX; j += j & (~j + 1))
+					_tree.set(j - 1, i - 1, _tree.get(j - 1, i - 1) + static_cast<uint32_t>(delta));
+			}
+		}
+
+		// Количество занятых клеток в тайлах [tx0, tx1] x [ty0, ty1] (границы включительно)
+		size_t count(int64_t tx0, int64_t ty0, int64_t tx1, int64_t ty1) const {
+			if (tx0 > tx1 || ty0 > ty1)
+				return 0;
+			return static_cast<size_t>(
+				prefix(tx1 + 1, ty1 + 1) - prefix(tx0, ty1 + 1) - prefix(tx1 + 1, ty0) + prefix(tx0, ty0));
+		}
+
+	private:
+		// Количество занятых клеток в тайлах [0, tx) x [0, ty)
+		uint64_t prefix(int64_t tx, int64_t ty) const {
+			uint64_t sum = 0;
+			for (uint32_t i = static_cast<uint32_t>(ty); i > 0; i -= i & (~i + 1)) {
+				for (uint32_t j = static_cast<uint32_t>(tx); j > 0; j -= j & (~j + 1))
+					sum += _tree.get(j - 1, i - 1);
+			}
+			return sum;
+		}
+
+		uint32_t _tilesX{};
+		uint32_t _tilesY{};
+		GridStore<uint32_t> _tree;
+	};
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "Coord.hpp"
+#include "GridMap.hpp"
+
+#include <cstdint>
+#include <vector>
+
+namespace sw::core {
+
+	// Занятость клеток для выбора шага и поиска пути.
+	// В обычном мире это карта мира. В мире шарда (shard::ShardedTicks) юниты разбиты на группы: клетки своей
+	// группы берутся с карты шарда, клетки остальных групп — со снимка всего боя на начало хода. Поэтому путь
+	// не зависит от того, какие группы попали в тот же шард, а поиск видит и юнитов других шардов
+	class PathingView {
+	public:
+		explicit PathingView(const GridMap& map)
+			: _map(&map)
+		{}
+
+		// groups — группа по слоту карты map, snapshotGroups — по слоту снимка, group — группа юнита, ищущего путь
+		PathingView(const GridMap& map, const std::vector<uint32_t>& groups, const GridMap& snapshot, const std::vector<uint32_t>& snapshotGroups, uint32_t group)
+			: _map(&map)
+			, _groups(&groups)
+			, _snapshot(&snapshot)
+			, _snapshotGroups(&snapshotGroups)
+			, _group(group)
+		{}
+
+		bool inBounds(const Coord& c) const {
+			return _map->inBounds(c);
+		}
+
+		bool isOccupied(const Coord& c) const {
+			if (!_snapshot)
+				return _map->isOccupied(c);
+			const int32_t own = _map->occupantId(c);
+			if (own != GridMap::kEmptyCell && (*_groups)[static_cast<size_t>(own)] == _group)
+				return true;
+			const int32_t other = _snapshot->occupantId(c);
+			return other != GridMap::kEmptyCell && (*_snapshotGroups)[static_cast<size_t>(other)] != _group;
+		}
+
+	private:
+		const GridMap* _map;
+		const std::vector<uint32_t>* _groups = nullptr;
+		const GridMap* _snapshot = nullptr;
+		const std::vector<uint32_t>* _snapshotGroups = nullptr;
+		uint32_t _group{};
+	};
+}
@@ -0,0 +1,94 @@
+#include "Perception.hpp"
+
+#include <algorithm>
+#include <tuple>
+
+namespace sw::core {
+
+	namespace {
+		// Номер прямоугольника, в который GridMap::nthOccupiedInRing относит клетку кольца с внутренним радиусом minD:
+		// полоса сверху, полоса снизу, левый бок, правый бок. Внутри прямоугольника клетки идут построчно
+		int32_t ringBand(const Coord& center, int32_t minD, const Coord& c) {
+			if (minD <= 0)
+				return 0;
+			if (int64_t{c.y} <= int64_t{center.y} - minD)
+				return 0;
+			if (int64_t{c.y} >= int64_t{center.y} + minD)
+				return 1;
+			if (int64_t{c.x} <= int64_t{center.x} - minD)
+				return 2;
+			return 3;
+		}
+	}
+
+	std::span<const PerceivedUnit> Perception::inRing(int32_t minD, int32_t maxD) const {
+		minD = std::max(minD, 0);
+		maxD = std::min(maxD, _radius);
+		if (minD > maxD)
+			return {};
+		return std::span<const PerceivedUnit>(_units).subspan(
+			_distanceStart[static_cast<size_t>(minD)],
+			_distanceStart[static_cast<size_t>(maxD) + 1] - _distanceStart[static_cast<size_t>(minD)]);
+	}
+
+	bool Perception::hasBlockingNeighbour() const {
+		const std::span<const PerceivedUnit> neighbours = inRing(1, 1);
+		return std::any_of(neighbours.begin(), neighbours.end(), [](const PerceivedUnit& unit) { return unit.blocksCell; });
+	}
+
+	void Perception::ringInCreationOrder(int32_t minD, int32_t maxD, std::vector<UnitHandle>& out) const {
+		out.clear();
+		for (const PerceivedUnit& unit : inRing(minD, maxD))
+			out.push_back(unit.handle);
+		std::sort(out.begin(), out.end(), [](const UnitHandle& a, const UnitHandle& b) { return a.slot < b.slot; });
+	}
+
+	std::optional<UnitHandle> Perception::nthInRing(int32_t minD, int32_t maxD, size_t n) const {
+		const std::span<const PerceivedUnit> ring = inRing(minD, maxD);
+		if (n >= ring.size())
+			return std::nullopt;
+
+		_scratch.clear();
+		for (const PerceivedUnit& unit : ring)
+			_scratch.push_back(&unit);
+		const auto nth = _scratch.begin() + static_cast<std::ptrdiff_t>(n);
+		if (_mapOrderedRings) {
+			std::nth_element(_scratch.begin(), nth, _scratch.end(), [&](const PerceivedUnit* a, const PerceivedUnit* b) {
+				return std::tuple(ringBand(_center, minD, a->position), a->position.y, a->position.x)
+					 < std::tuple(ringBand(_center, minD, b->position), b->position.y, b->position.x);
+			});
+		} else {
+			std::nth_element(_scratch.begin(), nth, _scratch.end(), [](const PerceivedUnit* a, const PerceivedUnit* b) {
+				return a->handle.slot < b->handle.slot;
+			});
+		}
+		return (*nth)->handle;
+	}
+
+	void Perception::reset(const Coord& center, int32_t radius, bool mapOrderedRings) {
+		_center = center;
+		_radius = radius;
+		_mapOrderedRings = mapOrderedRings;
+		_units.clear();
+		_distanceStart.clear();
+	}
+
+	void Perception::add(const PerceivedUnit& unit) {
+		_units.push_back(unit);
+	}
+
+	void Perception::finish() {
+		std::sort(_units.begin(), _units.end(), [](const PerceivedUnit& a, const PerceivedUnit& b) {
+			return std::tie(a.distance, a.handle.slot) < std::tie(b.distance, b.handle.slot);
+		});
+		if (_radius < 0)
+			return;
+		_distanceStart.resize(static_cast<size_t>(_radius) + 2);
+		size_t i = 0;
+		for (int32_t d = 0; d <= _radius + 1; ++d) {
+			while (i < _units.size() && _units[i].distance < d)
+				++i;
+			_distanceStart[static_cast<size_t>(d)] = i;
+		}
+	}
+}
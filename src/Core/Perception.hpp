@@ -0,0 +1,85 @@
+#pragma once
+
+#include "Coord.hpp"
+#include "UnitHandle.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace sw::core {
+
+	// Какая окрестность нужна поведению в его ходу. Не меняется за время жизни поведения
+	struct PerceptionNeeds {
+		// Юниты на расстоянии Чебышева не больше radius; отрицательный — окрестность не нужна
+		int32_t radius = -1;
+		// Нужны ли блокирующие соседи (расстояние 1)
+		bool blockingNeighbours = false;
+
+		// Объединение потребностей нескольких поведений
+		PerceptionNeeds merged(const PerceptionNeeds& other) const {
+			PerceptionNeeds result{std::max(radius, other.radius), blockingNeighbours || other.blockingNeighbours};
+			if (result.blockingNeighbours && result.radius < 1)
+				result.radius = 1;
+			return result;
+		}
+	};
+
+	struct PerceivedUnit {
+		UnitHandle handle;
+		Coord position;
+		int32_t distance{};
+		bool blocksCell{};
+	};
+
+	// Окрестность юнита, собранная World::perceive одним запросом в начале его хода и общая для всех его поведений.
+	// Юниты упорядочены по расстоянию, а при равном расстоянии — по порядку создания,
+	// поэтому кольцо [minD, maxD] — непрерывный отрезок. Здоровье в окрестность не входит: его читают через ручку
+	class Perception {
+	public:
+		const Coord& center() const {
+			return _center;
+		}
+
+		int32_t radius() const {
+			return _radius;
+		}
+
+		// Покрывает ли окрестность все клетки на расстоянии до maxD
+		bool covers(int32_t maxD) const {
+			return maxD <= _radius;
+		}
+
+		// Юниты на расстоянии [minD, maxD]; maxD не больше radius()
+		std::span<const PerceivedUnit> inRing(int32_t minD, int32_t maxD) const;
+
+		// Есть ли блокирующий юнит на расстоянии 1
+		bool hasBlockingNeighbour() const;
+
+		// Ручки юнитов кольца в порядке создания — как World::unitsInChebyshevRing
+		void ringInCreationOrder(int32_t minD, int32_t maxD, std::vector<UnitHandle>& out) const;
+
+		// n-й юнит кольца в том же порядке, что World::nthUnitInChebyshevRing: в порядке обхода кольца картой,
+		// а не в порядке создания (пока есть юниты, не занимающие клетки, — в порядке создания)
+		std::optional<UnitHandle> nthInRing(int32_t minD, int32_t maxD, size_t n) const;
+
+	private:
+		friend class World;
+
+		void reset(const Coord& center, int32_t radius, bool mapOrderedRings);
+		void add(const PerceivedUnit& unit);
+		void finish();
+
+		Coord _center{};
+		int32_t _radius = -1;
+		// Порядок nthInRing: как у индекса занятости карты (когда все юниты занимают клетки) или по созданию
+		bool _mapOrderedRings = true;
+		std::vector<PerceivedUnit> _units;
+		// _units[_distanceStart[d]] — первый юнит на расстоянии d; размер radius + 2
+		std::vector<size_t> _distanceStart;
+		mutable std::vector<const PerceivedUnit*> _scratch;
+	};
+}
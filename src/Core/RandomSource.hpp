@@ -0,0 +1,45 @@
+#pragma once
+
+#include "Zobrist.hpp"
+
+#include <cstdint>
+#include <cstdlib>
+
+namespace sw::core {
+
+	// Случайные числа для поведений (TurnContext::random), значения в [0, RAND_MAX].
+	// По умолчанию — std::rand: последовательность задается std::srand и зависит от порядка всех ходов.
+	// В режиме с ключом у каждого хода юнита свой поток, зависящий только от ключа, юнита и номера хода,
+	// поэтому ходы можно выполнять на разных потоках (шардирование) с тем же результатом
+	class RandomSource {
+	public:
+		RandomSource() = default;
+
+		explicit RandomSource(uint64_t key)
+			: _keyed(true)
+			, _key(key)
+		{}
+
+		bool keyed() const {
+			return _keyed;
+		}
+
+		// Начало хода юнита: в режиме с ключом — новый поток
+		void beginTurn(uint32_t unitId, uint64_t tick) {
+			if (_keyed)
+				_state = zobrist::mix(zobrist::mix(_key ^ unitId) ^ tick);
+		}
+
+		uint32_t next() {
+			if (!_keyed)
+				return static_cast<uint32_t>(std::rand());
+			_state = zobrist::mix(_state);
+			return static_cast<uint32_t>(_state >> 33) % (static_cast<uint32_t>(RAND_MAX) + 1u);
+		}
+
+	private:
+		bool _keyed = false;
+		uint64_t _key{};
+		uint64_t _state{};
+	};
+}
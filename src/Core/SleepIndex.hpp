@@ -0,0 +1,158 @@
+#pragma once
+
+#include "Coord.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace sw::core {
+
+	// Пространственный индекс спящих юнитов.
+	// По клетке, в которой изменился мир, находит спящих, в чей радиус восприятия она попадает.
+	// Спящий регистрируется во всех корзинах, которые покрывает его радиус. Корзины образуют уровни:
+	// на нулевом — квадраты kBucketSize x kBucketSize, на каждом следующем сторона в kLevelScale раз больше.
+	// Спящий попадает на самый мелкий уровень, где покрывает не больше kMaxBucketsPerSleeper корзин,
+	// поэтому дальнобойный юнит занимает несколько крупных корзин, а не просматривается при каждом изменении.
+	// Устаревшие записи (юнит уже проснулся или уснул заново) удаляются лениво при просмотре корзины.
+	class SleepIndex {
+	public:
+		bool empty() const {
+			return _sleepingCount == 0;
+		}
+
+		bool contains(size_t slot) const {
+			return slot < _sleeping.size() && _sleeping[slot];
+		}
+
+		void add(size_t slot, const Coord& position, int32_t radius) {
+			if (slot >= _sleeping.size()) {
+				_sleeping.resize(slot + 1, false);
+				_epochs.resize(slot + 1, 0);
+			}
+			if (!_sleeping[slot])
+				++_sleepingCount;
+			_sleeping[slot] = true;
+			const Sleeper sleeper{slot, position, radius, ++_epochs[slot]};
+
+			int64_t minBucketX = 0;
+			int64_t minBucketY = 0;
+			int64_t maxBucketX = 0;
+			int64_t maxBucketY = 0;
+			size_t level = 0;
+			for (;; ++level) {
+				minBucketX = bucketOf(std::max<int64_t>(int64_t{position.x} - radius, 0), level);
+				minBucketY = bucketOf(std::max<int64_t>(int64_t{position.y} - radius, 0), level);
+				maxBucketX = bucketOf(int64_t{position.x} + radius, level);
+				maxBucketY = bucketOf(int64_t{position.y} + radius, level);
+				// На последнем уровне любой радиус умещается в одну корзину
+				if ((maxBucketX - minBucketX + 1) * (maxBucketY - minBucketY + 1) <= kMaxBucketsPerSleeper || level + 1 == kLevels)
+					break;
+			}
+			Buckets& buckets = _levels[level];
+			for (int64_t by = minBucketY; by <= maxBucketY; ++by) {
+				for (int64_t bx = minBucketX; bx <= maxBucketX; ++bx)
+					buckets[bucketKey(bx, by)].push_back(sleeper);
+			}
+		}
+
+		void remove(size_t slot) {
+			if (!contains(slot))
+				return;
+			_sleeping[slot] = false;
+			if (--_sleepingCount == 0) {
+				for (Buckets& buckets : _levels)
+					buckets.clear();
+			}
+		}
+
+		// Возвращает спящих, в чей радиус восприятия попадает клетка. Сами записи не удаляются
+		std::vector<size_t> affectedBy(const Coord& c) {
+			std::vector<size_t> affected;
+			if (empty())
+				return affected;
+
+			for (size_t level = 0; level < kLevels; ++level) {
+				Buckets& buckets = _levels[level];
+				if (buckets.empty())
+					continue;
+				auto it = buckets.find(bucketKey(bucketOf(c.x, level), bucketOf(c.y, level)));
+				if (it == buckets.end())
+					continue;
+				collect(it->second, c, affected);
+				if (it->second.empty())
+					buckets.erase(it);
+			}
+			return affected;
+		}
+
+		// Попадает ли клетка в радиус восприятия какого-нибудь спящего; индекс не меняется
+		bool anyAffectedBy(const Coord& c) const {
+			if (empty())
+				return false;
+			for (size_t level = 0; level < kLevels; ++level) {
+				const Buckets& buckets = _levels[level];
+				auto it = buckets.find(bucketKey(bucketOf(c.x, level), bucketOf(c.y, level)));
+				if (it == buckets.end())
+					continue;
+				for (const Sleeper& sleeper : it->second) {
+					if (isCurrent(sleeper) && chebyshevDistance(sleeper.position, c) <= sleeper.radius)
+						return true;
+				}
+			}
+			return false;
+		}
+
+	private:
+		struct Sleeper {
+			size_t slot{};
+			Coord position{};
+			int32_t radius{};
+			uint32_t epoch{};
+		};
+
+		using Buckets = std::unordered_map<uint64_t, std::vector<Sleeper>>;
+
+		static constexpr int32_t kBucketShift = 4;
+		static constexpr int32_t kLevelScaleShift = 3;
+		static constexpr int32_t kBucketSize = 1 << kBucketShift;
+		static constexpr int32_t kLevelScale = 1 << kLevelScaleShift;
+		static constexpr int64_t kMaxBucketsPerSleeper = 64;
+		// Сторона корзины последнего уровня (2^34) больше любой координаты с прибавленным радиусом
+		static constexpr size_t kLevels = 11;
+
+		// Координаты в корзинах неотрицательны: левая и верхняя границы радиуса обрезаются по нулю
+		static int64_t bucketOf(int64_t coordinate, size_t level) {
+			return coordinate >> (kBucketShift + kLevelScaleShift * static_cast<int32_t>(level));
+		}
+
+		static uint64_t bucketKey(int64_t bx, int64_t by) {
+			return (static_cast<uint64_t>(by) << 32) | static_cast<uint64_t>(bx);
+		}
+
+		bool isCurrent(const Sleeper& sleeper) const {
+			return _sleeping[sleeper.slot] && _epochs[sleeper.slot] == sleeper.epoch;
+		}
+
+		void collect(std::vector<Sleeper>& sleepers, const Coord& c, std::vector<size_t>& affected) {
+			// Попутно выбрасываем устаревшие записи
+			auto last = std::remove_if(sleepers.begin(), sleepers.end(), [&](const Sleeper& sleeper) {
+				if (!isCurrent(sleeper))
+					return true;
+				if (chebyshevDistance(sleeper.position, c) > sleeper.radius)
+					return false;
+				affected.push_back(sleeper.slot);
+				return true;
+			});
+			sleepers.erase(last, sleepers.end());
+		}
+
+		std::array<Buckets, kLevels> _levels;
+		std::vector<bool> _sleeping;
+		std::vector<uint32_t> _epochs;
+		size_t _sleepingCount{};
+	};
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <unordered_set>
+
+namespace sw::core {
+
+	// Обнаружение повтора состояния мира по хешам на границах ходов при ограниченной памяти.
+	// Хеши первых kExactStates ходов хранятся все, и возврат в любое из этих состояний замечается сразу.
+	// Дальше набор не растет: кроме него новый хеш сравнивается с одним опорным, который переставляется
+	// на текущий ход через 1, 2, 4, ... ходов (алгоритм Брента). Цикл, начавшийся позже, обнаруживается
+	// не позднее чем через 2 * (ход начала + период) ходов
+	class StateCycleDetector {
+	public:
+		static constexpr size_t kExactStates = 16384;
+
+		// true, если состояние с таким хешем уже встречалось
+		bool seen(uint64_t hash) {
+			if (_exact.size() < kExactStates)
+				return !_exact.insert(hash).second;
+			if (_exact.contains(hash) || _anchor == hash)
+				return true;
+			if (_sinceAnchor == _window) {
+				_anchor = hash;
+				_window *= 2;
+				_sinceAnchor = 0;
+			}
+			++_sinceAnchor;
+			return false;
+		}
+
+	private:
+		std::unordered_set<uint64_t> _exact;
+		std::optional<uint64_t> _anchor;
+		uint64_t _window = 1;
+		uint64_t _sinceAnchor = 1;
+	};
+}
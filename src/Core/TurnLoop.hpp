@@ -0,0 +1,38 @@
+#pragma once
+
+#include "Perception.hpp"
+#include "RandomSource.hpp"
+#include "Unit.hpp"
+#include "World.hpp"
+
+#include <cstdint>
+
+namespace sw::core {
+
+	// Ходы всех бодрствующих юнитов мира в порядке создания; afterTurn(unit) вызывается после хода каждого.
+	// Юнит, не сумевший действовать, засыпает. Возвращает true, если действовал хотя бы один юнит
+	template <class F>
+	bool takeTurns(World& world, ::sw::EventLog& log, uint64_t tick, Perception& perception, RandomSource& random, F&& afterTurn) {
+		WorldView worldView(world);
+		bool anyActed = false;
+		for (const auto& uptr : world.unitsInCreationOrder()) {
+			// Спящий юнит заведомо не сможет действовать: вокруг него ничего не изменилось
+			if (!uptr || uptr->asleep())
+				continue;
+
+			// Одна выборка окрестности на ход юнита вместо отдельного запроса в каждом поведении.
+			// В тихий ход атаковать некого: юнит только идет, события те же, что у обычного хода
+			const bool quiet = world.isQuietTurn(*uptr, tick);
+			const PerceptionNeeds& needs = quiet ? uptr->quietPerceptionNeeds() : uptr->perceptionNeeds();
+			world.perceive(*uptr, needs.radius, perception);
+			random.beginTurn(uptr->id(), tick);
+			TurnContext ctx{worldView, log, tick, perception, random};
+			if (quiet ? uptr->takeQuietTurn(ctx) : uptr->takeTurn(ctx))
+				anyActed = true;
+			else
+				world.putToSleep(*uptr);
+			afterTurn(*uptr);
+		}
+		return anyActed;
+	}
+}
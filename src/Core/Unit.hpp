@@ -2,7 +2,12 @@
 
 #include "Coord.hpp"
 #include "IBehavior.hpp"
+#include "ObjectPool.hpp"
+#include "Perception.hpp"
+#include "RandomSource.hpp"
 
+#include <algorithm>
+#include <cstddef>
 #include <cstdint>
 #include <memory>
 #include <optional>
@@ -21,6 +26,21 @@ namespace sw::core {
 		WorldView& world;
 		::sw::EventLog& log;
 		uint64_t tick{};
+		// Окрестность юнита на начало его хода радиусом perceptionNeeds().radius
+		const Perception& perception;
+		// Источник случайного выбора целей; ход юнита начинается с random.beginTurn
+		RandomSource& random;
+	};
+
+	// Окно тихих ходов юнита (World::isQuietTurn)
+	struct QuietSchedule {
+		// Последний ход текущего окна
+		uint64_t until{};
+		// Ход следующей проверки и задержка до нее после неудачной
+		uint64_t nextCheck{};
+		uint64_t checkDelay{1};
+		// Число слотов мира при расчете окна: новые юниты делают его недействительным
+		size_t unitCount{};
 	};
 
 	class Unit {
@@ -61,21 +81,108 @@ namespace sw::core {
 			return _march;
 		}
 
+		// Спящий юнит пропускает ходы, пока рядом что-то не изменится
+		bool asleep() const {
+			return _asleep;
+		}
+
+		// Радиус сна: изменения мира дальше него не могут изменить хода юнита. std::nullopt — юнит нельзя усыплять
+		std::optional<int32_t> perceptionRadius() const {
+			using Locality = BehaviorTraits::Locality;
+			if (_locality == Locality::Global || (_locality == Locality::NeighbourhoodUnlessMarching && _march))
+				return std::nullopt;
+			return std::max(_perceptionNeeds.radius, 0);
+		}
+
+		// Объединенные потребности в окрестности всех поведений
+		const PerceptionNeeds& perceptionNeeds() const {
+			return _perceptionNeeds;
+		}
+
+		// То же только для поведений, не зависящих от других юнитов (для takeQuietTurn)
+		const PerceptionNeeds& quietPerceptionNeeds() const {
+			return _quietPerceptionNeeds;
+		}
+
+		// Наибольшая дальность взаимодействия среди поведений; std::nullopt — юнит ни с кем не взаимодействует
+		std::optional<int32_t> interactionReach() const {
+			return _interactionReach;
+		}
+
+		// Наибольшее смещение за ход; std::nullopt — у какого-то поведения оно неизвестно
+		std::optional<int32_t> maxStepPerTurn() const {
+			return _maxStep;
+		}
+
+		void addBehavior(PoolPtr<IBehavior> behavior) {
+			if (!behavior)
+				return;
+			const BehaviorTraits traits = behavior->traits();
+			_perceptionNeeds = _perceptionNeeds.merged(traits.perception);
+			if (traits.interactionReach)
+				_interactionReach = std::max(_interactionReach.value_or(*traits.interactionReach), *traits.interactionReach);
+			else
+				_quietPerceptionNeeds = _quietPerceptionNeeds.merged(traits.perception);
+			_maxStep = _maxStep && traits.maxStepPerTurn ? std::optional<int32_t>(std::max(*_maxStep, *traits.maxStepPerTurn)) : std::nullopt;
+			_locality = std::max(_locality, traits.locality);
+			_behaviors.push_back(Behavior{std::move(behavior), traits.interactionReach.has_value(), traits.maxStepPerTurn});
+		}
+
 		void addBehavior(std::unique_ptr<IBehavior> behavior) {
-			if (behavior) _behaviors.push_back(std::move(behavior));
+			addBehavior(adoptHeapObject(std::move(behavior)));
 		}
 
 		bool takeTurn(TurnContext& ctx) {
-			for (const auto& behavior : _behaviors) {
-				if (!behavior)
+			for (const Behavior& behavior : _behaviors) {
+				if (behavior.ptr->tryAct(*this, ctx))
+					return true;
+			}
+			return false;
+		}
+
+		// Ход, в котором ни один юнит заведомо не в пределах interactionReach: поведения, зависящие от соседей,
+		// вернули бы false, поэтому выполняются только независимые. Результат тот же, что у takeTurn
+		bool takeQuietTurn(TurnContext& ctx) {
+			for (const Behavior& behavior : _behaviors) {
+				if (behavior.interacts)
 					continue;
-				if (behavior->tryAct(*this, ctx))
+				if (behavior.ptr->tryAct(*this, ctx))
 					return true;
 			}
 			return false;
 		}
 
+		// План марша для пропуска ходов (World::planMarchSkip). В тихий ход действует первое поведение,
+		// не зависящее от соседей, поэтому план берется у него. Возвращает его шаг за ход; std::nullopt — плана нет
+		std::optional<int32_t> planMarch(const GridMap& map, size_t maxCells, std::vector<Coord>& cells) const {
+			const Behavior* behavior = firstIndependentBehavior();
+			if (!behavior || !behavior->maxStep || !behavior->ptr->planMarch(*this, map, maxCells, cells))
+				return std::nullopt;
+			return behavior->maxStep;
+		}
+
+		void skipMarchSteps(size_t steps) {
+			if (const Behavior* behavior = firstIndependentBehavior())
+				behavior->ptr->skipMarchSteps(steps);
+		}
+
 	private:
+		// Поведение и нужные в каждом ходу поля его BehaviorTraits
+		struct Behavior {
+			PoolPtr<IBehavior> ptr;
+			// Задан ли interactionReach
+			bool interacts{};
+			std::optional<int32_t> maxStep;
+		};
+
+		const Behavior* firstIndependentBehavior() const {
+			for (const Behavior& behavior : _behaviors) {
+				if (!behavior.interacts)
+					return &behavior;
+			}
+			return nullptr;
+		}
+
 		void setHp(int32_t value) {
 			_hp = value < 0 ? 0 : value;
 		}
@@ -96,7 +203,17 @@ namespace sw::core {
 		int32_t _hp{0};
 		bool _blocksCell{true};
 		std::optional<sw::core::Coord> _march;
-		std::vector<std::unique_ptr<IBehavior>> _behaviors;
+		bool _asleep{false};
+		// Индекс юнита в World (порядок создания), назначается при spawn
+		size_t _slot{};
+		std::vector<Behavior> _behaviors;
+		PerceptionNeeds _perceptionNeeds;
+		PerceptionNeeds _quietPerceptionNeeds;
+		std::optional<int32_t> _interactionReach;
+		std::optional<int32_t> _maxStep{0};
+		// Наименее локальное поведение; без поведений юнит засыпает
+		BehaviorTraits::Locality _locality = BehaviorTraits::Locality::Neighbourhood;
+		QuietSchedule _quiet;
 	};
 }
 
@@ -0,0 +1,16 @@
+#pragma once
+
+#include <cstdint>
+
+namespace sw::core {
+
+	// Ссылка на юнита внутри World: индекс слота и поколение слота.
+	// Разрешение ручки — обращение к массиву и сравнение поколения, без поиска по id.
+	// Поколение слота меняется при удалении юнита, поэтому ручка погибшего юнита больше не разрешается
+	struct UnitHandle {
+		uint32_t slot{};
+		uint32_t generation{};
+
+		bool operator==(const UnitHandle&) const = default;
+	};
+}
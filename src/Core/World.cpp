@@ -1,6 +1,11 @@
 #include "World.hpp"
 
+#include "DistanceKernel.hpp"
+#include "Zobrist.hpp"
+
+#include <algorithm>
 #include <stdexcept>
+#include <unordered_set>
 
 namespace sw::core {
 
@@ -8,7 +13,7 @@ namespace sw::core {
 		: _map(std::move(map))
 	{}
 
-	const std::vector<std::unique_ptr<Unit>>& World::unitsInCreationOrder() const {
+	const std::vector<PoolPtr<Unit>>& World::unitsInCreationOrder() const {
 		return _units;
 	}
 
@@ -45,7 +50,31 @@ namespace sw::core {
 		return u && u->blocksCell();
 	}
 
+	UnitHandle World::handleOf(const Unit& unit) const {
+		return handleAt(unit._slot);
+	}
+
+	UnitHandle World::handleAt(size_t idx) const {
+		return UnitHandle{static_cast<uint32_t>(idx), _generations[idx]};
+	}
+
+	Unit* World::resolve(UnitHandle handle) {
+		if (handle.slot >= _units.size() || _generations[handle.slot] != handle.generation)
+			return nullptr;
+		return _units[handle.slot].get();
+	}
+
+	const Unit* World::resolve(UnitHandle handle) const {
+		if (handle.slot >= _units.size() || _generations[handle.slot] != handle.generation)
+			return nullptr;
+		return _units[handle.slot].get();
+	}
+
 	void World::spawn(std::unique_ptr<Unit> unit) {
+		spawn(adoptHeapObject(std::move(unit)));
+	}
+
+	void World::checkSpawn(const Unit* unit) const {
 		if (!unit)
 			throw std::runtime_error("spawn: unit is null");
 		if (unit->hp() < 0)
@@ -56,80 +85,444 @@ namespace sw::core {
 			throw std::runtime_error("spawn: out of bounds");
 		if (unit->blocksCell() && _map.isOccupied(unit->position()))
 			throw std::runtime_error("spawn: cell is occupied");
+	}
+
+	void World::spawn(PoolPtr<Unit> unit) {
+		checkSpawn(unit.get());
+		placeUnit(std::move(unit));
+	}
+
+	void World::placeUnit(PoolPtr<Unit> unit) {
+		wakeAround(unit->position());
 
 		const size_t idx = _units.size();
+		_generations.push_back(0);
+		_xs.push_back(0);
+		_ys.push_back(0);
+		_stats.push_back(UnitStats{unit->id()});
+		_units.emplace_back();
+		insertUnit(idx, std::move(unit));
+		if (_trackDirty)
+			_dirtyCells.push_back(_units[idx]->position());
+	}
+
+	void World::insertUnit(size_t idx, PoolPtr<Unit> unit) {
 		_byId.emplace(unit->id(), idx);
+		unit->_slot = idx;
+		unit->_quiet = QuietSchedule{};
+		_xs[idx] = unit->position().x;
+		_ys[idx] = unit->position().y;
 		if (unit->blocksCell())
-			_map.setOccupied(unit->position(), static_cast<int32_t>(unit->id()));
-		_units.emplace_back(std::move(unit));
+			_map.setOccupied(unit->position(), static_cast<int32_t>(idx));
+		else
+			++_nonBlockingUnits;
+		_stateHash ^= unitHash(*unit);
+		if (_maxStep)
+			_maxStep = unit->maxStepPerTurn() ? std::optional<int32_t>(std::max(*_maxStep, *unit->maxStepPerTurn())) : std::nullopt;
+		// Спящий юнит переходит из другого мира: он не двигался с момента засыпания, радиус тот же
+		if (unit->_asleep) {
+			const std::optional<int32_t> radius = unit->perceptionRadius();
+			if (radius)
+				_sleepers.add(idx, unit->position(), *radius);
+			else
+				unit->_asleep = false;
+		}
+		_units[idx] = std::move(unit);
+	}
+
+	PoolPtr<Unit> World::detachUnit(size_t idx) {
+		Unit* unit = _units[idx].get();
+		if (!unit)
+			return {};
+		if (unit->blocksCell())
+			_map.clear(unit->position());
+		else
+			--_nonBlockingUnits;
+		_stateHash ^= unitHash(*unit);
+		_sleepers.remove(idx);
+		_byId.erase(unit->id());
+		_xs[idx] = kernels::kRemovedCoord;
+		_ys[idx] = kernels::kRemovedCoord;
+		return std::move(_units[idx]);
+	}
+
+	PoolPtr<Unit> World::lendUnit(size_t slot) {
+		return detachUnit(slot);
+	}
+
+	void World::adoptUnit(PoolPtr<Unit> unit) {
+		checkSpawn(unit.get());
+		const size_t idx = _units.size();
+		_generations.push_back(0);
+		_xs.push_back(0);
+		_ys.push_back(0);
+		_stats.push_back(UnitStats{unit->id()});
+		_units.emplace_back();
+		insertUnit(idx, std::move(unit));
+	}
+
+	void World::returnUnit(size_t slot, PoolPtr<Unit> unit, const UnitStats& stats) {
+		_stats[slot].damageDealt += stats.damageDealt;
+		_stats[slot].damageTaken += stats.damageTaken;
+		// Ручки погибшего в шарде юнита больше не разрешаются
+		if (!unit) {
+			++_generations[slot];
+			return;
+		}
+		insertUnit(slot, std::move(unit));
+	}
+
+	void World::spawn(std::vector<PoolPtr<Unit>> units) {
+		std::unordered_set<uint32_t> ids;
+		std::unordered_set<uint64_t> cells;
+		ids.reserve(units.size());
+		cells.reserve(units.size());
+		for (const auto& unit : units) {
+			checkSpawn(unit.get());
+			if (!ids.insert(unit->id()).second)
+				throw std::runtime_error("spawn: duplicate unit id");
+			const Coord& position = unit->position();
+			if (unit->blocksCell() && !cells.insert((static_cast<uint64_t>(static_cast<uint32_t>(position.y)) << 32) | static_cast<uint32_t>(position.x)).second)
+				throw std::runtime_error("spawn: cell is occupied");
+		}
+
+		const size_t total = _units.size() + units.size();
+		_units.reserve(total);
+		_byId.reserve(total);
+		_generations.reserve(total);
+		_xs.reserve(total);
+		_ys.reserve(total);
+		_stats.reserve(total);
+		for (auto& unit : units)
+			placeUnit(std::move(unit));
 	}
 
 	// Соседи по всем юнитам в 8 смежных клетках (и болкирующие клетку и нет)
-	std::vector<uint32_t> World::neighboringUnits(const Coord& center) {
+	std::vector<UnitHandle> World::neighboringUnits(const Coord& center) {
 		return unitsInChebyshevRing(center, 1, 1);
 	}
 
-	std::vector<uint32_t> World::unitsInChebyshevRing(const Coord& center, int32_t minD, int32_t maxD) {
-		std::vector<uint32_t> result;
-		for (const auto& uptr : _units) {
-			if (!uptr)
-				continue;
-			const Coord unitPosition = uptr->position();
-			const int32_t distanceToUnit = chebyshevDistance(center, unitPosition);
-			if (distanceToUnit >= minD && distanceToUnit <= maxD)
-				result.push_back(uptr->id());
-		}
+	std::vector<UnitHandle> World::unitsInChebyshevRing(const Coord& center, int32_t minD, int32_t maxD) {
+		std::vector<uint32_t> slots;
+		kernels::chebyshevRing(_xs.data(), _ys.data(), _xs.size(), center, minD, maxD, slots);
+		// Слоты идут в порядке создания
+		std::vector<UnitHandle> result;
+		result.reserve(slots.size());
+		for (uint32_t slot : slots)
+			result.push_back(handleAt(slot));
 		return result;
 	}
 
+	size_t World::countUnitsInChebyshevRing(const Coord& center, int32_t minD, int32_t maxD) {
+		if (_nonBlockingUnits == 0)
+			return _map.occupiedInRing(center, minD, maxD);
+		return unitsInChebyshevRing(center, minD, maxD).size();
+	}
+
+	std::optional<UnitHandle> World::nthUnitInChebyshevRing(const Coord& center, int32_t minD, int32_t maxD, size_t n) {
+		if (_nonBlockingUnits == 0) {
+			const std::optional<Coord> cell = _map.nthOccupiedInRing(center, minD, maxD, n);
+			if (!cell)
+				return std::nullopt;
+			return handleAt(static_cast<size_t>(_map.occupantId(*cell)));
+		}
+		const std::vector<UnitHandle> handles = unitsInChebyshevRing(center, minD, maxD);
+		if (n >= handles.size())
+			return std::nullopt;
+		return handles[n];
+	}
+
+	// Блокирующие юниты — ровно те, что занимают клетки карты, поэтому хватает битовой карты занятости
 	bool World::hasNeighbouringBlockingUnit(const Coord& coordinate) {
-		for (uint32_t id : neighboringUnits(coordinate)) {
-			if (getUnitBlocksCell(id))
+		return _map.anyOccupiedAround(coordinate);
+	}
+
+	void World::perceive(const Unit& unit, int32_t radius, Perception& out) const {
+		const Coord center = unit.position();
+		radius = std::min(radius, kMaxPerceptionRadius);
+		out.reset(center, radius, _nonBlockingUnits == 0);
+		if (radius < 0)
+			return;
+
+		_map.forEachOccupiedInRect(Coord{center.x - radius, center.y - radius}, Coord{center.x + radius, center.y + radius}, [&](const Coord& cell, int32_t occupant) {
+			const size_t idx = static_cast<size_t>(occupant);
+			out.add(PerceivedUnit{handleAt(idx), cell, chebyshevDistance(center, cell), true});
+		});
+		// Юниты, не занимающие клетки, карта не видит
+		if (_nonBlockingUnits > 0) {
+			std::vector<uint32_t> slots;
+			kernels::chebyshevRing(_xs.data(), _ys.data(), _xs.size(), center, 0, radius, slots);
+			for (uint32_t slot : slots) {
+				const Unit& other = *_units[slot];
+				if (!other.blocksCell())
+					out.add(PerceivedUnit{handleAt(slot), other.position(), chebyshevDistance(center, other.position()), false});
+			}
+		}
+		out.finish();
+	}
+
+	bool World::isQuietTurn(Unit& unit, uint64_t tick) {
+		QuietSchedule& schedule = unit._quiet;
+		// Окно, посчитанное до появления новых юнитов, недействительно
+		if (schedule.unitCount == _units.size()) {
+			if (tick <= schedule.until)
 				return true;
+			if (tick < schedule.nextCheck)
+				return false;
+		}
+		schedule.unitCount = _units.size();
+
+		const uint64_t window = quietTurnsFor(unit);
+		if (window == 0) {
+			// В бою проверка не нужна каждый ход: откладываем ее все дальше
+			schedule.checkDelay = std::min(schedule.checkDelay * 2, kMaxQuietTurns);
+			schedule.nextCheck = tick + schedule.checkDelay;
+			schedule.until = 0;
+			return false;
+		}
+		schedule.checkDelay = 1;
+		schedule.until = tick + window - 1;
+		return true;
+	}
+
+	// Между двумя ходами юнита расстояние до любого другого сокращается не больше чем на 2 * maxStep
+	// (каждый из двоих ходит один раз), поэтому k ходов подряд, считая текущий, тихие,
+	// если ближайший другой юнит дальше reach + 2 * maxStep * (k - 1)
+	uint64_t World::quietTurnsFor(const Unit& unit) const {
+		const std::optional<int32_t> reach = unit.interactionReach();
+		if (!reach)
+			return kMaxQuietTurns;
+		return turnsBeyondReach(unit, *reach);
+	}
+
+	uint64_t World::turnsBeyondReach(const Unit& unit, int64_t reach) const {
+		if (_nonBlockingUnits > 0 || !_maxStep)
+			return 0;
+
+		const int64_t step = 2 * int64_t{*_maxStep};
+		const int64_t radius = reach + step * static_cast<int64_t>(kMaxQuietTurns - 1);
+		const Coord c = unit.position();
+		int64_t nearest = radius + 1;
+		_map.forEachOccupiedInRect(
+			Coord{static_cast<int32_t>(std::max<int64_t>(c.x - radius, 0)), static_cast<int32_t>(std::max<int64_t>(c.y - radius, 0))},
+			Coord{static_cast<int32_t>(std::min<int64_t>(c.x + radius, _map.width() - 1)), static_cast<int32_t>(std::min<int64_t>(c.y + radius, _map.height() - 1))},
+			[&](const Coord& cell, int32_t) {
+				if (cell != c)
+					nearest = std::min<int64_t>(nearest, chebyshevDistance(c, cell));
+			});
+		if (nearest <= reach)
+			return 0;
+		if (step == 0)
+			return kMaxQuietTurns;
+		return std::min<uint64_t>(static_cast<uint64_t>((nearest - reach - 1) / step) + 1, kMaxQuietTurns);
+	}
+
+	uint64_t World::planMarchSkip(uint64_t maxTurns, MarchSkip& skip) const {
+		skip.marchers.clear();
+		skip.cells.clear();
+		skip.stateHashes.clear();
+		if (_nonBlockingUnits > 0 || !_maxStep || *_maxStep == 0)
+			return 0;
+
+		// Атаковать можно в пределах reach, а занять клетку на пути юнита — только вплотную к нему:
+		// за свой ход юнит проходит не больше maxStep клеток, поэтому на начало хода хватает расстояния
+		// больше max(reach, maxStep). План считается до хода всех юнитов, а quietTurnsFor — на ход самого юнита,
+		// когда юниты перед ним уже сходили, отсюда еще один maxStep. Расстояние проверяется до построения плана:
+		// в бою или в плотном строю неудача видна сразу
+		uint64_t turns = std::min(maxTurns, kMaxQuietTurns);
+		for (size_t idx = 0; idx < _units.size(); ++idx) {
+			const Unit* unit = _units[idx].get();
+			if (!unit)
+				continue;
+			// Юнит с нулевым hp будет удален в конце хода
+			if (unit->hp() <= 0)
+				return 0;
+			if (unit->asleep())
+				continue;
+			const std::optional<Coord> target = unit->marchTarget();
+			if (!target)
+				return 0;
+			turns = std::min(turns, turnsBeyondReach(*unit, std::max(unit->interactionReach().value_or(0), *_maxStep) + *_maxStep));
+			if (turns == 0)
+				return 0;
+
+			const size_t firstCell = skip.cells.size();
+			const std::optional<int32_t> stepsPerTurn = unit->planMarch(_map, static_cast<size_t>(turns * static_cast<uint64_t>(*_maxStep)), skip.cells);
+			if (!stepsPerTurn || *stepsPerTurn <= 0)
+				return 0;
+			const MarchSkip::Marcher& marcher = skip.marchers.emplace_back(
+				MarchSkip::Marcher{idx, unit->id(), *target, *stepsPerTurn, firstCell, skip.cells.size() - firstCell});
+			// После плана юнит ходит иначе: пропускаются только ходы, целиком идущие по плану.
+			// Ход, в котором марш заканчивается, — последний
+			const uint64_t step = static_cast<uint64_t>(marcher.stepsPerTurn);
+			const bool arrives = marcher.cellCount > 0 && skip.cells.back() == marcher.target;
+			turns = std::min<uint64_t>(turns, arrives ? (marcher.cellCount + step - 1) / step : marcher.cellCount / step);
+			if (turns == 0)
+				return 0;
+		}
+		if (skip.marchers.empty())
+			return 0;
+
+		// Спящий проснулся бы от шага рядом с ним и мог бы действовать: ходы пропускаются только до такого шага
+		if (!_sleepers.empty()) {
+			for (const MarchSkip::Marcher& marcher : skip.marchers) {
+				Coord from = _units[marcher.slot]->position();
+				const size_t steps = marcher.stepsIn(turns);
+				for (size_t s = 0; s < steps; ++s) {
+					const Coord to = skip.cells[marcher.firstCell + s];
+					if (_sleepers.anyAffectedBy(from) || _sleepers.anyAffectedBy(to)) {
+						turns = s / static_cast<size_t>(marcher.stepsPerTurn);
+						break;
+					}
+					from = to;
+				}
+				if (turns == 0)
+					return 0;
+			}
+		}
+
+		// Хеш меняется, как в applyMove и clearUnitMarch на каждом шаге
+		uint64_t hash = _stateHash;
+		for (uint64_t turn = 0; turn < turns; ++turn) {
+			for (const MarchSkip::Marcher& marcher : skip.marchers) {
+				const size_t before = marcher.stepsIn(turn);
+				const size_t after = marcher.stepsIn(turn + 1);
+				if (before == after)
+					continue;
+				const Coord from = before == 0 ? _units[marcher.slot]->position() : skip.cells[marcher.firstCell + before - 1];
+				const Coord to = skip.cells[marcher.firstCell + after - 1];
+				hash ^= zobrist::positionKey(marcher.unitId, from) ^ zobrist::positionKey(marcher.unitId, to);
+				if (to == marcher.target)
+					hash ^= zobrist::marchKey(marcher.unitId, marcher.target) ^ zobrist::marchKey(marcher.unitId, std::nullopt);
+			}
+			skip.stateHashes.push_back(hash);
+		}
+		return turns;
+	}
+
+	void World::applyMarchSkip(const MarchSkip& skip, uint64_t turns) {
+		for (const MarchSkip::Marcher& marcher : skip.marchers) {
+			const size_t steps = marcher.stepsIn(turns);
+			if (steps == 0)
+				continue;
+			Unit& unit = *_units[marcher.slot];
+			const Coord to = skip.cells[marcher.firstCell + steps - 1];
+			// Спящих рядом с пройденными клетками нет (planMarchSkip): сразу в конечную клетку
+			applyMove(unit, to);
+			if (to == marcher.target)
+				clearUnitMarch(unit);
+			unit.skipMarchSteps(steps);
 		}
-		return false;
 	}
 
 	const GridMap& World::map() const {
 		return _map;
 	}
 
+	PathingView World::pathingView(const Unit& unit) const {
+		if (!_pathingSnapshot)
+			return PathingView(_map);
+		return PathingView(_map, _pathingGroups, _pathingSnapshot(), *_pathingSnapshotGroups, _pathingGroups[unit._slot]);
+	}
+
+	void World::setPathingGroups(std::vector<uint32_t> groups, std::function<const GridMap&()> snapshot, const std::vector<uint32_t>& snapshotGroups) {
+		_pathingGroups = std::move(groups);
+		_pathingSnapshot = std::move(snapshot);
+		_pathingSnapshotGroups = &snapshotGroups;
+	}
+
+	const Unit* World::unitAt(const Coord& c) const {
+		const int32_t occupant = _map.occupantId(c);
+		return occupant == GridMap::kEmptyCell ? nullptr : _units[static_cast<size_t>(occupant)].get();
+	}
+
+	void World::setDirtyTracking(bool enabled) {
+		_trackDirty = enabled;
+		_dirtyCells.clear();
+	}
+
+	std::vector<Coord> World::takeDirtyCells() {
+		std::vector<Coord> cells;
+		cells.swap(_dirtyCells);
+		return cells;
+	}
+
 	void World::applyMove(Unit& unit, const Coord& to) {
 		const Coord from = unit.position();
+		if (unit.asleep())
+			wake(unit._slot);
+		wakeAround(from);
+		wakeAround(to);
 		if (unit.blocksCell()) {
 			_map.clear(from);
-			_map.setOccupied(to, static_cast<int32_t>(unit.id()));
+			_map.setOccupied(to, static_cast<int32_t>(unit._slot));
 		}
+		_stateHash ^= zobrist::positionKey(unit.id(), from) ^ zobrist::positionKey(unit.id(), to);
 		unit.setPosition(to);
+		if (_trackDirty) {
+			_dirtyCells.push_back(from);
+			_dirtyCells.push_back(to);
+		}
+		_xs[unit._slot] = to.x;
+		_ys[unit._slot] = to.y;
 	}
 
-	void World::changeUnitHp(uint32_t unitId, int32_t delta) {
-		Unit* u = getUnit(unitId);
-		if (u)
-			u->setHp(u->hp() + delta);
+	void World::changeUnitHp(UnitHandle target, int32_t delta) {
+		Unit* u = resolve(target);
+		if (!u)
+			return;
+		_stateHash ^= zobrist::hpKey(u->id(), u->hp());
+		u->setHp(u->hp() + delta);
+		_stateHash ^= zobrist::hpKey(u->id(), u->hp());
+		if (delta < 0)
+			_stats[u->_slot].damageTaken += static_cast<uint64_t>(-int64_t{delta});
+	}
+
+	void World::addDamageDealt(const Unit& attacker, int32_t damage) {
+		if (damage > 0)
+			_stats[attacker._slot].damageDealt += static_cast<uint64_t>(damage);
 	}
 
 	void World::setUnitMarchTarget(uint32_t unitId, const Coord& target) {
 		Unit* u = getUnit(unitId);
-		if (u)
-			u->setMarchTarget(target);
+		if (!u)
+			return;
+		_stateHash ^= zobrist::marchKey(unitId, u->marchTarget());
+		u->setMarchTarget(target);
+		_stateHash ^= zobrist::marchKey(unitId, u->marchTarget());
+		if (u->asleep())
+			wake(u->_slot);
 	}
 
-	void World::clearUnitMarch(uint32_t unitId) {
-		Unit* u = getUnit(unitId);
-		if (u)
-			u->clearMarch();
+	void World::clearUnitMarch(Unit& unit) {
+		_stateHash ^= zobrist::marchKey(unit.id(), unit.marchTarget());
+		unit.clearMarch();
+		_stateHash ^= zobrist::marchKey(unit.id(), unit.marchTarget());
 	}
 
 	std::vector<uint32_t> World::removeDeadUnits() {
+		return removeUnits(deadUnitSlots());
+	}
+
+	std::vector<size_t> World::deadUnitSlots() const {
+		std::vector<size_t> slots;
+		for (size_t idx = 0; idx < _units.size(); ++idx) {
+			const Unit* unit = _units[idx].get();
+			if (unit && unit->hp() <= 0)
+				slots.push_back(idx);
+		}
+		return slots;
+	}
+
+	std::vector<uint32_t> World::removeUnits(const std::vector<size_t>& slots) {
 		std::vector<uint32_t> removed;
-		for (const auto& uptr : _units) {
-			if (!uptr || uptr->hp() > 0)
+		removed.reserve(slots.size());
+		for (size_t idx : slots) {
+			if (!_units[idx])
 				continue;
-			removed.push_back(uptr->id());
+			removed.push_back(_units[idx]->id());
+			removeUnit(idx);
 		}
-		for (uint32_t id : removed)
-			removeUnit(id);
 		return removed;
 	}
 
@@ -142,20 +535,48 @@ namespace sw::core {
 		return count;
 	}
 
-	void World::removeUnit(uint32_t id) {
-		auto it = _byId.find(id);
-		if (it == _byId.end())
-			return;
+	const std::vector<UnitStats>& World::unitStats() const {
+		return _stats;
+	}
 
-		const size_t idx = it->second;
-		Unit* unit = _units[idx].get();
-		if (!unit)
+	uint64_t World::stateHash() const {
+		return _stateHash;
+	}
+
+	uint64_t World::unitHash(const Unit& unit) {
+		return zobrist::positionKey(unit.id(), unit.position())
+			 ^ zobrist::hpKey(unit.id(), unit.hp())
+			 ^ zobrist::marchKey(unit.id(), unit.marchTarget());
+	}
+
+	void World::putToSleep(Unit& unit) {
+		const std::optional<int32_t> radius = unit.perceptionRadius();
+		if (!radius)
 			return;
-		if (unit->blocksCell())
-			_map.clear(unit->position());
+		_sleepers.add(unit._slot, unit.position(), *radius);
+		unit._asleep = true;
+	}
 
-		_byId.erase(it);
-		_units[idx].reset();
+	void World::wake(size_t idx) {
+		_sleepers.remove(idx);
+		if (_units[idx])
+			_units[idx]->_asleep = false;
+	}
+
+	void World::wakeAround(const Coord& c) {
+		for (size_t idx : _sleepers.affectedBy(c))
+			wake(idx);
+	}
+
+	void World::removeUnit(size_t idx) {
+		if (!_units[idx])
+			return;
+		const Coord position = _units[idx]->position();
+		detachUnit(idx).reset();
+		++_generations[idx];
+		if (_trackDirty)
+			_dirtyCells.push_back(position);
+		wakeAround(position);
 	}
 
 	// WorldView
@@ -165,14 +586,26 @@ namespace sw::core {
 		return _world.map();
 	}
 
-	std::vector<uint32_t> WorldView::neighboringUnits(const Coord& center) {
+	PathingView WorldView::pathingView(const Unit& unit) const {
+		return _world.pathingView(unit);
+	}
+
+	std::vector<UnitHandle> WorldView::neighboringUnits(const Coord& center) {
 		return _world.neighboringUnits(center);
 	}
 
-	std::vector<uint32_t> WorldView::unitsInChebyshevRing(const Coord& center, int32_t minD, int32_t maxD) {
+	std::vector<UnitHandle> WorldView::unitsInChebyshevRing(const Coord& center, int32_t minD, int32_t maxD) {
 		return _world.unitsInChebyshevRing(center, minD, maxD);
 	}
 
+	size_t WorldView::countUnitsInChebyshevRing(const Coord& center, int32_t minD, int32_t maxD) {
+		return _world.countUnitsInChebyshevRing(center, minD, maxD);
+	}
+
+	std::optional<UnitHandle> WorldView::nthUnitInChebyshevRing(const Coord& center, int32_t minD, int32_t maxD, size_t n) {
+		return _world.nthUnitInChebyshevRing(center, minD, maxD, n);
+	}
+
 	bool WorldView::hasNeighbouringBlockingUnit(const Coord& coordinate) {
 		return _world.hasNeighbouringBlockingUnit(coordinate);
 	}
@@ -181,16 +614,24 @@ namespace sw::core {
 		_world.applyMove(unit, to);
 	}
 
-	void WorldView::changeHP(uint32_t unitId, int32_t delta) {
-		_world.changeUnitHp(unitId, delta);
+	void WorldView::changeHP(UnitHandle target, int32_t delta) {
+		_world.changeUnitHp(target, delta);
+	}
+
+	void WorldView::addDamageDealt(const Unit& attacker, int32_t damage) {
+		_world.addDamageDealt(attacker, damage);
 	}
 
 	void WorldView::setMarchTarget(uint32_t unitId, const Coord& target) {
 		_world.setUnitMarchTarget(unitId, target);
 	}
 
-	void WorldView::clearMarch(uint32_t unitId) {
-		_world.clearUnitMarch(unitId);
+	void WorldView::clearMarch(Unit& unit) {
+		_world.clearUnitMarch(unit);
+	}
+
+	const Unit* WorldView::resolve(UnitHandle handle) const {
+		return _world.resolve(handle);
 	}
 
 	std::optional<int32_t> WorldView::getUnitHp(uint32_t unitId) const {
@@ -2,9 +2,17 @@
 
 #include "Coord.hpp"
 #include "GridMap.hpp"
+#include "ObjectPool.hpp"
+#include "PathingView.hpp"
+#include "Perception.hpp"
+#include "SleepIndex.hpp"
 #include "Unit.hpp"
+#include "UnitHandle.hpp"
 
+#include <algorithm>
+#include <cstddef>
 #include <cstdint>
+#include <functional>
 #include <memory>
 #include <optional>
 #include <unordered_map>
@@ -12,39 +20,196 @@
 
 namespace sw::core {
 
+	// Счетчики итоговой статистики боя. Хранятся по слотам и остаются после смерти юнита
+	struct UnitStats {
+		uint32_t unitId{};
+		uint64_t damageDealt{};
+		uint64_t damageTaken{};
+	};
+
+	// Ходы, пропускаемые целиком (World::planMarchSkip): бодрствующие юниты идут по своим планам марша
+	struct MarchSkip {
+		struct Marcher {
+			size_t slot{};
+			uint32_t unitId{};
+			Coord target{};
+			int32_t stepsPerTurn{};
+			// Клетки плана — cells[firstCell, firstCell + cellCount) в порядке прохождения
+			size_t firstCell{};
+			size_t cellCount{};
+
+			// Сколько клеток плана пройдено за turns ходов
+			size_t stepsIn(uint64_t turns) const {
+				return static_cast<size_t>(std::min<uint64_t>(turns * static_cast<uint64_t>(stepsPerTurn), cellCount));
+			}
+		};
+
+		// В порядке создания
+		std::vector<Marcher> marchers;
+		std::vector<Coord> cells;
+		// stateHash после каждого пропускаемого хода
+		std::vector<uint64_t> stateHashes;
+	};
+
 	class World {
 	public:
 		explicit World(GridMap map);
 
-		const std::vector<std::unique_ptr<Unit>>& unitsInCreationOrder() const;
+		// Юниты и поведения ссылаются на пул мира, поэтому мир не копируется и не перемещается
+		World(const World&) = delete;
+		World& operator=(const World&) = delete;
 
+		const std::vector<PoolPtr<Unit>>& unitsInCreationOrder() const;
+
+		// Пул, из которого фабрики создают юнитов и их поведения. Память погибших юнитов переиспользуется
+		ObjectPool& pool() {
+			return _pool;
+		}
+
+		void spawn(PoolPtr<Unit> unit);
 		void spawn(std::unique_ptr<Unit> unit);
+		// Пакетное создание: память под всех юнитов резервируется сразу, проверки те же, что у spawn.
+		// Весь пакет проверяется до вставки (включая совпадения id и клеток внутри пакета): при ошибке мир не меняется
+		void spawn(std::vector<PoolPtr<Unit>> units);
+
+		// Перенос юнитов между мирами при шардировании. lendUnit забирает живого юнита, не меняя его состояния
+		// и не будя соседей; слот остается за юнитом до returnUnit. adoptUnit добавляет юнита в мир шарда
+		// (как spawn, но сон сохраняется). returnUnit возвращает юнита на его слот вместе с набранной в шарде
+		// статистикой; nullptr — юнит погиб в шарде
+		PoolPtr<Unit> lendUnit(size_t slot);
+		void adoptUnit(PoolPtr<Unit> unit);
+		void returnUnit(size_t slot, PoolPtr<Unit> unit, const UnitStats& stats);
 
 		std::optional<int32_t> getUnitHp(uint32_t unitId) const;
 		std::optional<Coord> getUnitPosition(uint32_t unitId) const;
 		bool getUnitBlocksCell(uint32_t unitId) const;
 
-		std::vector<uint32_t> neighboringUnits(const Coord& center);
-		std::vector<uint32_t> unitsInChebyshevRing(const Coord& center, int32_t minD, int32_t maxD);
+		UnitHandle handleOf(const Unit& unit) const;
+		// Юнит по ручке; nullptr, если юнит уже удален
+		Unit* resolve(UnitHandle handle);
+		const Unit* resolve(UnitHandle handle) const;
+
+		// Запросы окрестности возвращают ручки в порядке создания юнитов
+		std::vector<UnitHandle> neighboringUnits(const Coord& center);
+		std::vector<UnitHandle> unitsInChebyshevRing(const Coord& center, int32_t minD, int32_t maxD);
+		// Количество юнитов в кольце и n-й из них без перечисления кольца (когда все юниты занимают клетки).
+		// n считается не в порядке создания, а в порядке обхода кольца картой: полосы сверху, снизу, слева
+		// и справа, каждая построчно (GridMap::nthOccupiedInRing). С юнитами, не занимающими клетки, — в порядке создания
+		size_t countUnitsInChebyshevRing(const Coord& center, int32_t minD, int32_t maxD);
+		std::optional<UnitHandle> nthUnitInChebyshevRing(const Coord& center, int32_t minD, int32_t maxD, size_t n);
 		bool hasNeighbouringBlockingUnit(const Coord& c);
 
+		// Окрестность юнита радиусом min(radius, kMaxPerceptionRadius) одним проходом по занятым клеткам карты
+		// (и по юнитам, не занимающим клетки, если такие есть). Буферы out переиспользуются между вызовами
+		static constexpr int32_t kMaxPerceptionRadius = 8;
+		void perceive(const Unit& unit, int32_t radius, Perception& out) const;
+
+		// Тихий ход юнита: рядом с ним заведомо никого нет в пределах interactionReach, поэтому поведения,
+		// зависящие от соседей, можно не вызывать (Unit::takeQuietTurn). Окно до kMaxQuietTurns тихих ходов
+		// считается по ближайшему соседу; если оно пустое, следующая проверка откладывается все дальше
+		static constexpr uint64_t kMaxQuietTurns = 16;
+		bool isQuietTurn(Unit& unit, uint64_t tick);
+
+		// Пропуск ходов вперед. Если каждый бодрствующий юнит идет по плану марша (Unit::planMarch),
+		// все ходы, пока никто не сможет атаковать, столкнуться или разбудить спящего, — тихие, и их события
+		// и состояния мира известны заранее. Возвращает, сколько ходов подряд (не больше maxTurns
+		// и kMaxQuietTurns) можно пропустить, и заполняет skip; 0 — ни одного
+		uint64_t planMarchSkip(uint64_t maxTurns, MarchSkip& skip) const;
+		// Переносит юнитов плана в положение после turns ходов (turns не больше, чем вернул planMarchSkip)
+		void applyMarchSkip(const MarchSkip& skip, uint64_t turns);
+
 		const GridMap& map() const;
+		// Занятость клеток для выбора шага и поиска пути юнита
+		PathingView pathingView(const Unit& unit) const;
+		// Мир шарда: группы юнитов по слотам и снимок всего боя с группами по слотам снимка (см. PathingView).
+		// snapshot вызывается только при поиске пути; снимок и его группы принадлежат вызывающему и живут дольше мира
+		void setPathingGroups(std::vector<uint32_t> groups, std::function<const GridMap&()> snapshot, const std::vector<uint32_t>& snapshotGroups);
+		// Юнит, занимающий клетку (только блокирующие клетку юниты)
+		const Unit* unitAt(const Coord& c) const;
+
+		// Учет клеток, в которых появился, исчез или сменился юнит (для отрисовки).
+		// takeDirtyCells возвращает накопленные с прошлого вызова клетки, возможно с повторами
+		void setDirtyTracking(bool enabled);
+		std::vector<Coord> takeDirtyCells();
 
 		void applyMove(Unit& unit, const Coord& to);
-		void changeUnitHp(uint32_t unitId, int32_t delta);
+		void changeUnitHp(UnitHandle target, int32_t delta);
+		void addDamageDealt(const Unit& attacker, int32_t damage);
 		void setUnitMarchTarget(uint32_t unitId, const Coord& target);
-		void clearUnitMarch(uint32_t unitId);
+		void clearUnitMarch(Unit& unit);
 		std::vector<uint32_t> removeDeadUnits();
+		// Слоты юнитов с hp <= 0 в порядке создания и их удаление по слотам (removeDeadUnits — обе части сразу).
+		// deadUnitSlots только читает мир, поэтому разные миры можно проверять параллельно
+		std::vector<size_t> deadUnitSlots() const;
+		std::vector<uint32_t> removeUnits(const std::vector<size_t>& slots);
 		size_t aliveUnitsCount() const;
 
+		// Наибольший шаг за ход среди всех созданных юнитов; std::nullopt — у кого-то неизвестен
+		std::optional<int32_t> maxStepPerTurn() const {
+			return _maxStep;
+		}
+
+		// Юниты, не занимающие клетку карты
+		size_t nonBlockingUnitsCount() const {
+			return _nonBlockingUnits;
+		}
+
+		// Статистика всех когда-либо созданных юнитов в порядке создания
+		const std::vector<UnitStats>& unitStats() const;
+
+		// Хеш Зобриста состояния мира (позиции, hp и цели марша всех юнитов).
+		// Поддерживается инкрементально всеми изменяющими методами
+		uint64_t stateHash() const;
+
+		// Усыпляет юнита, который не смог действовать в этом ходу.
+		// Он проснется, когда в его радиусе восприятия кто-то появится, сдвинется или умрет, либо получит MARCH
+		void putToSleep(Unit& unit);
+
 	private:
 		Unit* getUnit(uint32_t id);
 		const Unit* getUnit(uint32_t id) const;
-		void removeUnit(uint32_t id);
-
+		void removeUnit(size_t idx);
+		// Юнит занимает слот idx: карта, индексы, хеш и сон. Проверки и пробуждение соседей — у вызывающего
+		void insertUnit(size_t idx, PoolPtr<Unit> unit);
+		void checkSpawn(const Unit* unit) const;
+		// spawn после проверки
+		void placeUnit(PoolPtr<Unit> unit);
+		// Убирает юнита слота idx из карты, индексов, хеша и сна; слот и поколение не меняются
+		PoolPtr<Unit> detachUnit(size_t idx);
+		UnitHandle handleAt(size_t idx) const;
+		static uint64_t unitHash(const Unit& unit);
+		// Сколько ходов юнита подряд, начиная с текущего и не больше kMaxQuietTurns, заведомо тихие
+		uint64_t quietTurnsFor(const Unit& unit) const;
+		// Сколько ходов подряд (не больше kMaxQuietTurns) все остальные юниты заведомо дальше reach от unit
+		uint64_t turnsBeyondReach(const Unit& unit, int64_t reach) const;
+		void wake(size_t idx);
+		void wakeAround(const Coord& c);
+
+		// Клетки карты хранят слот занимающего юнита
 		GridMap _map;
-		std::vector<std::unique_ptr<Unit>> _units;
+		// Объявлен до _units: юниты возвращают память в пул при уничтожении мира
+		ObjectPool _pool;
+		std::vector<PoolPtr<Unit>> _units;
 		std::unordered_map<uint32_t, size_t> _byId;
+		// Поколения слотов для UnitHandle
+		std::vector<uint32_t> _generations;
+		// Координаты юнитов по слотам в виде отдельных массивов для векторного поиска по расстоянию.
+		// Удаленные слоты хранят kernels::kRemovedCoord
+		std::vector<int32_t> _xs;
+		std::vector<int32_t> _ys;
+		// Юниты, не занимающие клетку, не видны индексу занятости карты
+		size_t _nonBlockingUnits{};
+		uint64_t _stateHash{};
+		SleepIndex _sleepers;
+		// Наибольший шаг за ход среди всех созданных юнитов; std::nullopt — у кого-то неизвестен
+		std::optional<int32_t> _maxStep{0};
+		std::vector<UnitStats> _stats;
+		// Для PathingView в мире шарда; без снимка — обычная карта
+		std::vector<uint32_t> _pathingGroups;
+		std::function<const GridMap&()> _pathingSnapshot;
+		const std::vector<uint32_t>* _pathingSnapshotGroups = nullptr;
+		bool _trackDirty{};
+		std::vector<Coord> _dirtyCells;
 	};
 
 	// WorldView с ограниченным доступом к миру
@@ -53,15 +218,20 @@ namespace sw::core {
 		explicit WorldView(World& world);
 
 		const GridMap& map() const;
-		std::vector<uint32_t> neighboringUnits(const Coord& center);
-		std::vector<uint32_t> unitsInChebyshevRing(const Coord& center, int32_t minD, int32_t maxD);
+		PathingView pathingView(const Unit& unit) const;
+		std::vector<UnitHandle> neighboringUnits(const Coord& center);
+		std::vector<UnitHandle> unitsInChebyshevRing(const Coord& center, int32_t minD, int32_t maxD);
+		size_t countUnitsInChebyshevRing(const Coord& center, int32_t minD, int32_t maxD);
+		std::optional<UnitHandle> nthUnitInChebyshevRing(const Coord& center, int32_t minD, int32_t maxD, size_t n);
 		bool hasNeighbouringBlockingUnit(const Coord& c);
 		void applyMove(Unit& unit, const Coord& to);
 
-		void changeHP(uint32_t unitId, int32_t delta);
+		void changeHP(UnitHandle target, int32_t delta);
+		void addDamageDealt(const Unit& attacker, int32_t damage);
 		void setMarchTarget(uint32_t unitId, const Coord& target);
-		void clearMarch(uint32_t unitId);
+		void clearMarch(Unit& unit);
 
+		const Unit* resolve(UnitHandle handle) const;
 		std::optional<int32_t> getUnitHp(uint32_t unitId) const;
 		std::optional<Coord> getUnitPosition(uint32_t unitId) const;
 		bool getUnitBlocksCell(uint32_t unitId) const;
@@ -0,0 +1,46 @@
+#pragma once
+
+#include "Coord.hpp"
+
+#include <cstdint>
+#include <optional>
+
+namespace sw::core::zobrist {
+
+	// Ключи Зобриста вычисляются хешированием признака, а не берутся из таблицы:
+	// размер карты и диапазон id не ограничены, таблица была бы огромной
+	inline uint64_t mix(uint64_t x) {
+		// splitmix64
+		x += 0x9E3779B97F4A7C15ull;
+		x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+		x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+		return x ^ (x >> 31);
+	}
+
+	enum class Feature : uint64_t {
+		Position = 1,
+		Hp = 2,
+		March = 3,
+	};
+
+	inline uint64_t key(Feature feature, uint32_t unitId, uint64_t value) {
+		return mix(mix((static_cast<uint64_t>(feature) << 32) | unitId) ^ value);
+	}
+
+	inline uint64_t packCoord(const Coord& c) {
+		return (static_cast<uint64_t>(static_cast<uint32_t>(c.y)) << 32) | static_cast<uint32_t>(c.x);
+	}
+
+	inline uint64_t positionKey(uint32_t unitId, const Coord& position) {
+		return key(Feature::Position, unitId, packCoord(position));
+	}
+
+	inline uint64_t hpKey(uint32_t unitId, int32_t hp) {
+		return key(Feature::Hp, unitId, static_cast<uint32_t>(hp));
+	}
+
+	// Отсутствие цели марша тоже признак: иначе юнит без марша и с маршем хешировались бы одинаково
+	inline uint64_t marchKey(uint32_t unitId, const std::optional<Coord>& target) {
+		return key(Feature::March, unitId, target ? packCoord(*target) : ~uint64_t{0});
+	}
+}
@@ -3,13 +3,15 @@
 #include <Features/Utils/TargetFilter.hpp>
 #include <Core/Coord.hpp>
 #include <Core/IBehavior.hpp>
+#include <Core/Perception.hpp>
 #include <Core/Unit.hpp>
+#include <Core/UnitHandle.hpp>
 #include <IO/Events/UnitAttacked.hpp>
 #include <IO/System/EventLog.hpp>
 
 #include <cstdint>
-#include <cstdlib>
 #include <optional>
+#include <vector>
 
 namespace sw::features {
 
@@ -18,28 +20,39 @@ namespace sw::features {
 		explicit MeleeAttackBehavior(int32_t damage) : _damage(damage) {}
 
 		bool tryAct(::sw::core::Unit& self, ::sw::core::TurnContext& ctx) override {
-			auto neighborIds = ctx.world.neighboringUnits(self.position());
-			auto targetIds = filterValidTargets(self.id(), neighborIds, ctx.world);
+			// Соседи из окрестности хода уже в порядке создания
+			std::vector<::sw::core::UnitHandle> targets;
+			for (const ::sw::core::PerceivedUnit& neighbour : ctx.perception.inRing(1, 1)) {
+				if (isValidTarget(self, neighbour.handle, ctx.world))
+					targets.push_back(neighbour.handle);
+			}
 
 			// Если нет целей, то не атакуем
-			if (targetIds.empty())
+			if (targets.empty())
 				return false;
 
 			// Выбираем случайную цель
-			uint32_t targetId = targetIds[static_cast<size_t>(std::rand()) % targetIds.size()];
+			::sw::core::UnitHandle target = targets[static_cast<size_t>(ctx.random.next()) % targets.size()];
 			// Наносим урон
-			ctx.world.changeHP(targetId, -_damage);
+			ctx.world.changeHP(target, -_damage);
+			ctx.world.addDamageDealt(self, _damage);
 			// Логируем атаку
-			std::optional<int32_t> newHp = ctx.world.getUnitHp(targetId);
-			ctx.log.log(ctx.tick, ::sw::io::UnitAttacked{
-					self.id(),
-					targetId,
-					static_cast<uint32_t>(_damage),
-					static_cast<uint32_t>(newHp.value_or(0)),
-				});
+			if (ctx.log.enabled<::sw::io::UnitAttacked>(ctx.tick)) {
+				const ::sw::core::Unit& targetUnit = *ctx.world.resolve(target);
+				ctx.log.log(ctx.tick, ::sw::io::UnitAttacked{
+						self.id(),
+						targetUnit.id(),
+						static_cast<uint32_t>(_damage),
+						static_cast<uint32_t>(targetUnit.hp()),
+					});
+			}
 			return true;
 		}
 
+		::sw::core::BehaviorTraits traits() const override {
+			return {{1, false}, ::sw::core::BehaviorTraits::Locality::Neighbourhood, 1, 0};
+		}
+
 	private:
 		int32_t _damage{};
 	};
@@ -3,6 +3,7 @@
 #include <Core/Coord.hpp>
 #include <Core/GridMap.hpp>
 #include <Core/IBehavior.hpp>
+#include <Core/PathingView.hpp>
 #include <Core/Unit.hpp>
 #include <Core/World.hpp>
 #include <Features/Utils/Pathfinding.hpp>
@@ -10,6 +11,10 @@
 #include <IO/Events/UnitMoved.hpp>
 #include <IO/System/EventLog.hpp>
 
+#include <algorithm>
+#include <optional>
+#include <vector>
+
 namespace sw::features {
 
 	class MoveBehavior final : public ::sw::core::IBehavior {
@@ -33,44 +38,192 @@ namespace sw::features {
 			for (int32_t step = 0; step < _stepsPerTurn; ++step) {
 				const ::sw::core::Coord from = self.position();
 				if (from == *target) {
-					ctx.world.clearMarch(self.id());
+					ctx.world.clearMarch(self);
 					break;
 				}
 
 				// Есть ли шаг?
-				bool foundStep = false;
-				for (const ::sw::core::Coord to : candidateStepsSorted(from, *target, map)) {
-					if (self.blocksCell() && map.isOccupied(to))
-						continue;
+				const std::optional<::sw::core::Coord> nextCell = nextStep(self, from, *target, map, ctx.world);
+				if (!nextCell)
+					break;
 
-					ctx.world.applyMove(self, to);
+				const ::sw::core::Coord to = *nextCell;
+				ctx.world.applyMove(self, to);
+				if (ctx.log.enabled<::sw::io::UnitMoved>(ctx.tick)) {
 					ctx.log.log(ctx.tick, ::sw::io::UnitMoved{
 							self.id(),
 							static_cast<uint32_t>(to.x),
 							static_cast<uint32_t>(to.y),
 						});
-					moved = true;
-					foundStep = true;
+				}
+				moved = true;
 
-					if (to == *target) {
+				if (to == *target) {
+					if (ctx.log.enabled<::sw::io::MarchEnded>(ctx.tick)) {
 						ctx.log.log(ctx.tick, ::sw::io::MarchEnded{
 								self.id(),
 								static_cast<uint32_t>(to.x),
 								static_cast<uint32_t>(to.y),
 							});
-						ctx.world.clearMarch(self.id());
 					}
-					break;
+					ctx.world.clearMarch(self);
 				}
-				if (!foundStep)
-					break;
 				if (!self.marchTarget())
 					break;
 			}
 			return moved;
 		}
 
+		::sw::core::BehaviorTraits traits() const override {
+			// Окрестность не читается: без цели марша двигаться некуда до команды MARCH.
+			// Во время марша путь может зависеть от любых клеток карты
+			return {{}, ::sw::core::BehaviorTraits::Locality::NeighbourhoodUnlessMarching, std::nullopt, _stepsPerTurn};
+		}
+
+		// Когда вокруг свободно, nextStep берет следующую клетку сохраненного пути, а без пути — жадный шаг,
+		// поэтому клетки следующих ходов известны. Соседей план не проверяет: это делает World::planMarchSkip
+		bool planMarch(
+			const ::sw::core::Unit& self,
+			const ::sw::core::GridMap& map,
+			size_t maxCells,
+			std::vector<::sw::core::Coord>& cells) const override
+		{
+			const auto target = self.marchTarget();
+			if (!target || _stuck || !self.blocksCell())
+				return false;
+
+			const size_t first = cells.size();
+			::sw::core::Coord from = self.position();
+			if (!_path.empty()) {
+				// Путь, который followCachedPath сбросит, не план
+				if (_pathTarget != *target || ::sw::core::chebyshevDistance(from, _path.back()) != 1)
+					return false;
+				for (size_t i = _path.size(); i-- > 0 && cells.size() - first < maxCells;)
+					cells.push_back(_path[i]);
+				return true;
+			}
+
+			while (from != *target && cells.size() - first < maxCells) {
+				const CandidateSteps candidates = candidateStepsSorted(from, *target, map);
+				if (candidates.empty() || !closerToTarget(candidates.front(), from, *target))
+					break;
+				from = candidates.front();
+				cells.push_back(from);
+			}
+			return cells.size() > first;
+		}
+
+		void skipMarchSteps(size_t steps) override {
+			_path.resize(_path.size() - std::min(steps, _path.size()));
+		}
+
 	private:
+		// Выбор следующего шага: сохраненный путь, затем жадный шаг, затем A*.
+		// Соседние клетки читаются с карты мира, а поиск пути и блокирующие клетки — через pathingView:
+		// в мире шарда юниты других групп рядом не бывают, но могут оказаться на пути
+		std::optional<::sw::core::Coord> nextStep(
+			const ::sw::core::Unit& self,
+			const ::sw::core::Coord& from,
+			const ::sw::core::Coord& target,
+			const ::sw::core::GridMap& map,
+			const ::sw::core::WorldView& world)
+		{
+			// Юнит, не занимающий клетку, не может быть заблокирован
+			if (!self.blocksCell()) {
+				const CandidateSteps candidates = candidateStepsSorted(from, target, map);
+				return candidates.empty() ? std::nullopt : std::optional<::sw::core::Coord>(candidates.front());
+			}
+
+			// Путь к цели заведомо отсутствует, пока не освободится одна из блокирующих клеток.
+			// Застрявший юнит и юнит на сохраненном пути соседей не перебирают
+			if (isStillStuck(self, from, target, world))
+				return std::nullopt;
+
+			if (auto cached = followCachedPath(from, target, map))
+				return cached;
+
+			const CandidateSteps candidates = candidateStepsSorted(from, target, map);
+
+			// Жадный шаг, если он приближает к цели. Кандидаты отсортированы,
+			// поэтому достаточно проверить первую свободную клетку
+			for (const ::sw::core::Coord& to : candidates) {
+				if (map.isOccupied(to))
+					continue;
+				if (closerToTarget(to, from, target))
+					return to;
+				break;
+			}
+
+			PathSearchResult search = findPath(from, target, world.pathingView(self));
+			switch (search.status) {
+				case PathSearchResult::Status::Found:
+					_path = std::move(search.reversedPath);
+					_pathTarget = target;
+					return followCachedPath(from, target, map);
+				case PathSearchResult::Status::Unreachable:
+					_stuck = StuckState{from, target, std::move(search.blockers)};
+					return std::nullopt;
+				case PathSearchResult::Status::BudgetExceeded:
+					break;
+			}
+
+			// Поиск не уложился в бюджет: старое поведение, любой свободный соседний шаг
+			for (const ::sw::core::Coord& to : candidates) {
+				if (!map.isOccupied(to))
+					return to;
+			}
+			return std::nullopt;
+		}
+
+		// Следующий шаг сохраненного пути, если путь все еще пригоден.
+		// Путь сбрасывается, только когда занята его очередная клетка (или сменилась цель)
+		std::optional<::sw::core::Coord> followCachedPath(
+			const ::sw::core::Coord& from,
+			const ::sw::core::Coord& target,
+			const ::sw::core::GridMap& map)
+		{
+			if (_path.empty() || _pathTarget != target || ::sw::core::chebyshevDistance(from, _path.back()) != 1) {
+				_path.clear();
+				return std::nullopt;
+			}
+
+			const ::sw::core::Coord next = _path.back();
+			if (map.isOccupied(next)) {
+				// Цель занята, а юнит уже рядом с ней: путь остается, просто ждем
+				if (next != target)
+					_path.clear();
+				return std::nullopt;
+			}
+			_path.pop_back();
+			return next;
+		}
+
+		bool isStillStuck(const ::sw::core::Unit& self, const ::sw::core::Coord& from, const ::sw::core::Coord& target, const ::sw::core::WorldView& world) {
+			if (!_stuck)
+				return false;
+			if (_stuck->from == from && _stuck->target == target) {
+				const ::sw::core::PathingView map = world.pathingView(self);
+				const bool allBlocked = std::all_of(
+					_stuck->blockers.begin(),
+					_stuck->blockers.end(),
+					[&](const ::sw::core::Coord& c) { return map.isOccupied(c); });
+				if (allBlocked)
+					return true;
+			}
+			_stuck.reset();
+			return false;
+		}
+
+		struct StuckState {
+			::sw::core::Coord from{};
+			::sw::core::Coord target{};
+			std::vector<::sw::core::Coord> blockers;
+		};
+
 		int32_t _stepsPerTurn;
+		// Сохраненный путь в обратном порядке: back() — следующий шаг
+		std::vector<::sw::core::Coord> _path;
+		std::optional<::sw::core::Coord> _pathTarget;
+		std::optional<StuckState> _stuck;
 	};
 }
@@ -1,13 +1,16 @@
 #pragma once
 
 #include <Features/Utils/TargetFilter.hpp>
+#include <Core/Coord.hpp>
 #include <Core/IBehavior.hpp>
+#include <Core/Perception.hpp>
 #include <Core/Unit.hpp>
+#include <Core/UnitHandle.hpp>
 #include <IO/Events/UnitAttacked.hpp>
 #include <IO/System/EventLog.hpp>
 
+#include <algorithm>
 #include <cstdint>
-#include <cstdlib>
 #include <optional>
 
 namespace sw::features {
@@ -22,31 +25,40 @@ namespace sw::features {
 		{}
 
 		bool tryAct(::sw::core::Unit& self, ::sw::core::TurnContext& ctx) override {
-			if (_requireNoNeighbouringUnits && ctx.world.hasNeighbouringBlockingUnit(self.position()))
+			if (_requireNoNeighbouringUnits && ctx.perception.hasBlockingNeighbour())
 				return false;
 
-			auto inRangeIds = ctx.world.unitsInChebyshevRing(self.position(), _minDist, _maxDist);
-			auto targetIds = filterValidTargets(self.id(), inRangeIds, ctx.world);
+			// Выбираем случайную цель из окрестности хода; кольцо шире окрестности — запросом к миру без перечисления кольца
+			std::optional<::sw::core::UnitHandle> target = ctx.perception.covers(_maxDist)
+				? pickRandomTargetInRing(self, ctx.perception, _minDist, _maxDist, ctx.world, ctx.random)
+				: pickRandomTargetInRing(self, self.position(), _minDist, _maxDist, ctx.world, ctx.random);
 
 			// Если нет целей, то не атакуем
-			if (targetIds.empty())
+			if (!target)
 				return false;
 
-			// Выбираем случайную цель
-			uint32_t targetId = targetIds[static_cast<size_t>(std::rand()) % targetIds.size()];
 			// Наносим урон
-			ctx.world.changeHP(targetId, -_damage);
+			ctx.world.changeHP(*target, -_damage);
+			ctx.world.addDamageDealt(self, _damage);
 			// Логируем атаку
-			std::optional<int32_t> newHp = ctx.world.getUnitHp(targetId);
-			ctx.log.log(ctx.tick, ::sw::io::UnitAttacked{
-					self.id(),
-					targetId,
-					static_cast<uint32_t>(_damage),
-					static_cast<uint32_t>(newHp.value_or(0)),
-				});
+			if (ctx.log.enabled<::sw::io::UnitAttacked>(ctx.tick)) {
+				const ::sw::core::Unit& targetUnit = *ctx.world.resolve(*target);
+				ctx.log.log(ctx.tick, ::sw::io::UnitAttacked{
+						self.id(),
+						targetUnit.id(),
+						static_cast<uint32_t>(_damage),
+						static_cast<uint32_t>(targetUnit.hp()),
+					});
+			}
 			return true;
 		}
 
+		// Соседи в радиусе 1 могут запретить выстрел. Без целей в кольце выстрел невозможен,
+		// соседи проверяются только для запрета выстрела, поэтому дальность взаимодействия — _maxDist
+		::sw::core::BehaviorTraits traits() const override {
+			return {{_maxDist, _requireNoNeighbouringUnits}, ::sw::core::BehaviorTraits::Locality::Neighbourhood, _maxDist, 0};
+		}
+
 	private:
 		int32_t _minDist{};
 		int32_t _maxDist{};
@@ -2,18 +2,65 @@
 
 #include <Core/Coord.hpp>
 #include <Core/GridMap.hpp>
+#include <Core/PathingView.hpp>
 
 #include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <queue>
+#include <unordered_map>
 #include <vector>
 
 namespace sw::features {
 
-	inline std::vector<::sw::core::Coord> candidateStepsSorted(
+	// Клетка a ближе к цели, чем b: сначала по Чебышеву, затем по |dx|, затем по |dy|
+	inline bool closerToTarget(
+		const ::sw::core::Coord& a,
+		const ::sw::core::Coord& b,
+		const ::sw::core::Coord& target)
+	{
+		const int32_t distanceToTargetA = ::sw::core::chebyshevDistance(a, target);
+		const int32_t distanceToTargetB = ::sw::core::chebyshevDistance(b, target);
+		if (distanceToTargetA != distanceToTargetB) return distanceToTargetA < distanceToTargetB;
+		const int32_t distanceToTargetXA = std::abs(a.x - target.x);
+		const int32_t distanceToTargetYA = std::abs(a.y - target.y);
+		const int32_t distanceToTargetXB = std::abs(b.x - target.x);
+		const int32_t distanceToTargetYB = std::abs(b.y - target.y);
+		if (distanceToTargetXA != distanceToTargetXB) return distanceToTargetXA < distanceToTargetXB;
+		return distanceToTargetYA < distanceToTargetYB;
+	}
+
+	// Соседние клетки в пределах карты (не больше 8); хранятся на месте, без выделения памяти в каждом ходу
+	struct CandidateSteps {
+		std::array<::sw::core::Coord, 8> cells{};
+		size_t count{};
+
+		const ::sw::core::Coord* begin() const {
+			return cells.data();
+		}
+
+		const ::sw::core::Coord* end() const {
+			return cells.data() + count;
+		}
+
+		bool empty() const {
+			return count == 0;
+		}
+
+		const ::sw::core::Coord& front() const {
+			return cells[0];
+		}
+	};
+
+	inline CandidateSteps candidateStepsSorted(
 		const ::sw::core::Coord& from,
 		const ::sw::core::Coord& target,
 		const ::sw::core::GridMap& map)
 	{
-		std::vector<::sw::core::Coord> candidates;
+		CandidateSteps candidates;
 
 		// Проходим по всем возможным клеткам вокруг текущей
 		for (int32_t dy = -1; dy <= 1; ++dy) {
@@ -25,22 +72,137 @@ namespace sw::features {
 
 				if (!map.inBounds(neighborCoord))
 					continue;
-				candidates.push_back(neighborCoord);
+				candidates.cells[candidates.count++] = neighborCoord;
 			}
 		}
 
 		// Сортируем клетки по дистанции до цели
-		std::sort(candidates.begin(), candidates.end(), [&](const ::sw::core::Coord& a, const ::sw::core::Coord& b) {
-			const int32_t distanceToTargetA = ::sw::core::chebyshevDistance(a, target);
-			const int32_t distanceToTargetB = ::sw::core::chebyshevDistance(b, target);
-			if (distanceToTargetA != distanceToTargetB) return distanceToTargetA < distanceToTargetB;
-			const int32_t distanceToTargetXA = std::abs(a.x - target.x);
-			const int32_t distanceToTargetYA = std::abs(a.y - target.y);
-			const int32_t distanceToTargetXB = std::abs(b.x - target.x);
-			const int32_t distanceToTargetYB = std::abs(b.y - target.y);
-			if (distanceToTargetXA != distanceToTargetXB) return distanceToTargetXA < distanceToTargetXB;
-			return distanceToTargetYA < distanceToTargetYB;
+		std::sort(candidates.cells.begin(), candidates.cells.begin() + candidates.count, [&](const ::sw::core::Coord& a, const ::sw::core::Coord& b) {
+			return closerToTarget(a, b, target);
 		});
 		return candidates;
 	}
+
+	struct PathSearchResult {
+		enum class Status {
+			Found,
+			Unreachable,
+			BudgetExceeded,
+		};
+
+		Status status{Status::BudgetExceeded};
+		// Шаги в обратном порядке: back() — ближайший шаг, front() — цель
+		std::vector<::sw::core::Coord> reversedPath;
+		// Для Unreachable: занятые клетки на границе исследованной области.
+		// Путь может появиться, только если освободится одна из них.
+		std::vector<::sw::core::Coord> blockers;
+	};
+
+	// Ограничение на количество раскрытых клеток, чтобы поиск к недостижимой цели
+	// не обходил всю огромную карту
+	constexpr size_t kDefaultPathSearchBudget = size_t{1} << 14;
+
+	// A* по 8 соседям с единичной стоимостью шага и эвристикой Чебышева.
+	// Занятые клетки непроходимы, кроме самой цели: если цель занята, путь ведет вплотную к ней.
+	inline PathSearchResult findPath(
+		const ::sw::core::Coord& from,
+		const ::sw::core::Coord& target,
+		const ::sw::core::PathingView& map,
+		size_t maxExpandedNodes = kDefaultPathSearchBudget)
+	{
+		struct Node {
+			int32_t cost{};
+			uint64_t parent{};
+			bool closed{};
+		};
+
+		struct OpenEntry {
+			int32_t estimate{};
+			int32_t heuristic{};
+			uint64_t key{};
+
+			bool operator>(const OpenEntry& other) const {
+				if (estimate != other.estimate) return estimate > other.estimate;
+				return heuristic > other.heuristic;
+			}
+		};
+
+		auto keyOf = [](const ::sw::core::Coord& c) {
+			return (static_cast<uint64_t>(static_cast<uint32_t>(c.y)) << 32) | static_cast<uint32_t>(c.x);
+		};
+		auto coordOf = [](uint64_t key) {
+			return ::sw::core::Coord{static_cast<int32_t>(key & 0xFFFFFFFFu), static_cast<int32_t>(key >> 32)};
+		};
+
+		PathSearchResult result;
+		std::unordered_map<uint64_t, Node> nodes;
+		std::priority_queue<OpenEntry, std::vector<OpenEntry>, std::greater<>> open;
+		std::vector<uint64_t> blockerKeys;
+
+		const uint64_t startKey = keyOf(from);
+		const uint64_t targetKey = keyOf(target);
+		nodes[startKey] = Node{0, startKey, false};
+		open.push(OpenEntry{::sw::core::chebyshevDistance(from, target), ::sw::core::chebyshevDistance(from, target), startKey});
+
+		size_t expanded = 0;
+		while (!open.empty()) {
+			const OpenEntry current = open.top();
+			open.pop();
+
+			Node& currentNode = nodes[current.key];
+			if (currentNode.closed)
+				continue;
+			currentNode.closed = true;
+
+			if (current.key == targetKey) {
+				for (uint64_t key = targetKey; key != startKey; key = nodes[key].parent)
+					result.reversedPath.push_back(coordOf(key));
+				result.status = PathSearchResult::Status::Found;
+				return result;
+			}
+
+			if (++expanded > maxExpandedNodes) {
+				result.status = PathSearchResult::Status::BudgetExceeded;
+				return result;
+			}
+
+			const ::sw::core::Coord c = coordOf(current.key);
+			const int32_t nextCost = currentNode.cost + 1;
+			for (int32_t dy = -1; dy <= 1; ++dy) {
+				for (int32_t dx = -1; dx <= 1; ++dx) {
+					if (dx == 0 && dy == 0)
+						continue;
+
+					const ::sw::core::Coord next{c.x + dx, c.y + dy};
+					if (!map.inBounds(next))
+						continue;
+
+					const uint64_t nextKey = keyOf(next);
+					if (nextKey == startKey)
+						continue;
+					if (nextKey != targetKey && map.isOccupied(next)) {
+						blockerKeys.push_back(nextKey);
+						continue;
+					}
+
+					auto [it, inserted] = nodes.try_emplace(nextKey, Node{nextCost, current.key, false});
+					if (!inserted) {
+						if (it->second.closed || it->second.cost <= nextCost)
+							continue;
+						it->second.cost = nextCost;
+						it->second.parent = current.key;
+					}
+					const int32_t heuristic = ::sw::core::chebyshevDistance(next, target);
+					open.push(OpenEntry{nextCost + heuristic, heuristic, nextKey});
+				}
+			}
+		}
+
+		std::sort(blockerKeys.begin(), blockerKeys.end());
+		blockerKeys.erase(std::unique(blockerKeys.begin(), blockerKeys.end()), blockerKeys.end());
+		for (uint64_t key : blockerKeys)
+			result.blockers.push_back(coordOf(key));
+		result.status = PathSearchResult::Status::Unreachable;
+		return result;
+	}
 }
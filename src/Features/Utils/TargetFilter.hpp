@@ -1,28 +1,108 @@
 #pragma once
 
+#include <Core/Coord.hpp>
+#include <Core/Perception.hpp>
+#include <Core/RandomSource.hpp>
+#include <Core/Unit.hpp>
+#include <Core/UnitHandle.hpp>
 #include <Core/World.hpp>
 
+#include <cstddef>
+#include <cstdint>
 #include <optional>
 #include <vector>
 
 namespace sw::features {
 
-	inline std::vector<uint32_t> filterValidTargets(
-		uint32_t selfId,
-		const std::vector<uint32_t>& candidateIds,
+	inline bool isValidTarget(const ::sw::core::Unit& self, ::sw::core::UnitHandle candidate, const ::sw::core::WorldView& world) {
+		const ::sw::core::Unit* unit = world.resolve(candidate);
+		// не атакуем себя и мертвых
+		return unit && unit != &self && unit->hp() > 0;
+	}
+
+	inline std::vector<::sw::core::UnitHandle> filterValidTargets(
+		const ::sw::core::Unit& self,
+		const std::vector<::sw::core::UnitHandle>& candidates,
 		const ::sw::core::WorldView& world)
 	{
-		std::vector<uint32_t> filteredTargets;
-		for (uint32_t id : candidateIds) {
-			// не атакуем себя
-			if (id == selfId)
-				continue;
-			std::optional<int32_t> hp = world.getUnitHp(id);
-			// не атакуем мертвых
-			if (!hp.has_value() || *hp <= 0)
-				continue;
-			filteredTargets.push_back(id);
+		std::vector<::sw::core::UnitHandle> filteredTargets;
+		for (::sw::core::UnitHandle candidate : candidates) {
+			if (isValidTarget(self, candidate, world))
+				filteredTargets.push_back(candidate);
 		}
 		return filteredTargets;
 	}
+
+	// Сколько раз пробуем выборку с отклонением, прежде чем перечислить кольцо целиком
+	constexpr int32_t kMaxRingSampleAttempts = 8;
+
+	// Выборка с отклонением из total кандидатов: nth(n) — n-й кандидат, all() — все кандидаты для полного перебора
+	template <class Nth, class All>
+	std::optional<::sw::core::UnitHandle> sampleValidTarget(
+		const ::sw::core::Unit& self,
+		size_t total,
+		Nth&& nth,
+		All&& all,
+		const ::sw::core::WorldView& world,
+		::sw::core::RandomSource& random)
+	{
+		if (total == 0)
+			return std::nullopt;
+
+		for (int32_t attempt = 0; attempt < kMaxRingSampleAttempts; ++attempt) {
+			const size_t n = static_cast<size_t>(random.next()) % total;
+			const std::optional<::sw::core::UnitHandle> candidate = nth(n);
+			if (candidate && isValidTarget(self, *candidate, world))
+				return candidate;
+		}
+
+		auto targets = filterValidTargets(self, all(), world);
+		if (targets.empty())
+			return std::nullopt;
+		return targets[static_cast<size_t>(random.next()) % targets.size()];
+	}
+
+	// Случайная подходящая цель в кольце Чебышева, равновероятно среди всех подходящих.
+	// Кандидат выбирается по индексу занятости карты без перечисления кольца и отбрасывается, если не подходит.
+	// Если подходящих мало и попытки исчерпаны — полный перебор, распределение от этого не меняется.
+	// Распределение то же, что у выбора из перечисления в порядке создания, но при том же зерне цель другая:
+	// индекс считается в порядке обхода кольца картой, а на отброшенных кандидатов уходят лишние случайные числа
+	inline std::optional<::sw::core::UnitHandle> pickRandomTargetInRing(
+		const ::sw::core::Unit& self,
+		const ::sw::core::Coord& center,
+		int32_t minD,
+		int32_t maxD,
+		::sw::core::WorldView& world,
+		::sw::core::RandomSource& random)
+	{
+		return sampleValidTarget(
+			self,
+			world.countUnitsInChebyshevRing(center, minD, maxD),
+			[&](size_t n) { return world.nthUnitInChebyshevRing(center, minD, maxD, n); },
+			[&] { return world.unitsInChebyshevRing(center, minD, maxD); },
+			world,
+			random);
+	}
+
+	// То же по окрестности хода (perception.covers(maxD)): те же кандидаты в том же порядке, без запросов к миру
+	inline std::optional<::sw::core::UnitHandle> pickRandomTargetInRing(
+		const ::sw::core::Unit& self,
+		const ::sw::core::Perception& perception,
+		int32_t minD,
+		int32_t maxD,
+		const ::sw::core::WorldView& world,
+		::sw::core::RandomSource& random)
+	{
+		return sampleValidTarget(
+			self,
+			perception.inRing(minD, maxD).size(),
+			[&](size_t n) { return perception.nthInRing(minD, maxD, n); },
+			[&] {
+				std::vector<::sw::core::UnitHandle> ring;
+				perception.ringInCreationOrder(minD, maxD, ring);
+				return ring;
+			},
+			world,
+			random);
+	}
 }
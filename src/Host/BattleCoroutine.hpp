@@ -0,0 +1,100 @@
+#pragma once
+
+#include <coroutine>
+#include <cstdint>
+#include <exception>
+#include <utility>
+
+namespace sw {
+	class SimulationRunner;
+}
+
+namespace sw::host {
+
+	// Сопрограмма боя: каждое возобновление выполняет один ход и приостанавливается на границе хода.
+	// Кадр сопрограммы хранит только ссылку на SimulationRunner, все состояние боя — в нем
+	class BattleCoroutine {
+	public:
+		struct promise_type {
+			uint64_t tick{};
+			std::exception_ptr error;
+
+			BattleCoroutine get_return_object() {
+				return BattleCoroutine(std::coroutine_handle<promise_type>::from_promise(*this));
+			}
+
+			// Первый ход выполняется при первом resume, а не при создании
+			std::suspend_always initial_suspend() noexcept {
+				return {};
+			}
+
+			std::suspend_always final_suspend() noexcept {
+				return {};
+			}
+
+			std::suspend_always yield_value(uint64_t completedTick) noexcept {
+				tick = completedTick;
+				return {};
+			}
+
+			void return_void() {}
+
+			void unhandled_exception() {
+				error = std::current_exception();
+			}
+		};
+
+		BattleCoroutine() = default;
+
+		BattleCoroutine(BattleCoroutine&& other) noexcept
+			: _handle(std::exchange(other._handle, {}))
+		{}
+
+		BattleCoroutine& operator=(BattleCoroutine&& other) noexcept {
+			if (this != &other) {
+				destroy();
+				_handle = std::exchange(other._handle, {});
+			}
+			return *this;
+		}
+
+		~BattleCoroutine() {
+			destroy();
+		}
+
+		// Выполняет следующий ход. false — бой закончен; исключение хода пробрасывается
+		bool resume() {
+			if (!_handle || _handle.done())
+				return false;
+			_handle.resume();
+			if (_handle.promise().error)
+				std::rethrow_exception(std::exchange(_handle.promise().error, {}));
+			return !_handle.done();
+		}
+
+		bool done() const {
+			return !_handle || _handle.done();
+		}
+
+		// Номер последнего выполненного хода
+		uint64_t tick() const {
+			return _handle ? _handle.promise().tick : 0;
+		}
+
+	private:
+		explicit BattleCoroutine(std::coroutine_handle<promise_type> handle)
+			: _handle(handle)
+		{}
+
+		void destroy() {
+			if (_handle)
+				_handle.destroy();
+			_handle = {};
+		}
+
+		std::coroutine_handle<promise_type> _handle;
+	};
+
+	// Тиковый цикл SimulationRunner в виде сопрограммы
+	BattleCoroutine playBattle(SimulationRunner& runner);
+}
@@ -0,0 +1,121 @@
+#include "BattleScheduler.hpp"
+
+#include <Core/Zobrist.hpp>
+
+#include <stdexcept>
+
+namespace sw::host {
+
+	BattleCoroutine playBattle(SimulationRunner& runner) {
+		while (runner.step(1) != 0)
+			co_yield runner.tick();
+	}
+
+	BattleScheduler::BattleScheduler(size_t threads, uint64_t randomSeed)
+		: _randomSeed(randomSeed) {
+		if (threads == 0)
+			throw std::runtime_error("Battle scheduler needs at least one thread");
+		_threads.reserve(threads);
+		for (size_t i = 0; i < threads; ++i)
+			_threads.emplace_back([this] { work(); });
+	}
+
+	BattleScheduler::~BattleScheduler() {
+		{
+			std::lock_guard lock(_mutex);
+			_stopping = true;
+		}
+		_ready.notify_all();
+		for (std::thread& thread : _threads)
+			thread.join();
+	}
+
+	BattleScheduler::BattleId BattleScheduler::add(std::unique_ptr<SimulationRunner> runner, uint64_t ticksPerSlice) {
+		if (!runner)
+			throw std::runtime_error("Battle runner is null");
+		if (ticksPerSlice == 0)
+			throw std::runtime_error("Battle tick budget must be positive");
+
+		BattleCoroutine coroutine = playBattle(*runner);
+		BattleId id = 0;
+		{
+			std::lock_guard lock(_mutex);
+			id = _battles.size();
+			runner->setRandomKey(randomKey(_randomSeed, id));
+			Battle& battle = _battles.emplace_back(Battle{std::move(runner), std::move(coroutine), ticksPerSlice, nullptr});
+			_queue.push_back(&battle);
+			++_unfinished;
+		}
+		_ready.notify_one();
+		return id;
+	}
+
+	void BattleScheduler::wait() {
+		std::unique_lock lock(_mutex);
+		_idle.wait(lock, [this] { return _unfinished == 0; });
+	}
+
+	size_t BattleScheduler::battleCount() const {
+		std::lock_guard lock(_mutex);
+		return _battles.size();
+	}
+
+	const SimulationRunner& BattleScheduler::battle(BattleId id) const {
+		std::lock_guard lock(_mutex);
+		return *_battles.at(id).runner;
+	}
+
+	SimulationRunner& BattleScheduler::battle(BattleId id) {
+		std::lock_guard lock(_mutex);
+		return *_battles.at(id).runner;
+	}
+
+	std::exception_ptr BattleScheduler::error(BattleId id) const {
+		std::lock_guard lock(_mutex);
+		return _battles.at(id).error;
+	}
+
+	uint64_t BattleScheduler::randomKey(uint64_t randomSeed, BattleId id) {
+		return core::zobrist::mix(core::zobrist::mix(randomSeed) ^ id);
+	}
+
+	bool BattleScheduler::runSlice(Battle& battle) {
+		try {
+			for (uint64_t i = 0; i < battle.ticksPerSlice; ++i) {
+				if (!battle.coroutine.resume())
+					return false;
+			}
+			return true;
+		} catch (...) {
+			battle.error = std::current_exception();
+			return false;
+		}
+	}
+
+	void BattleScheduler::work() {
+		std::unique_lock lock(_mutex);
+		while (true) {
+			_ready.wait(lock, [this] { return _stopping || !_queue.empty(); });
+			// Незаконченные бои при остановке бросаются
+			if (_stopping)
+				return;
+
+			Battle* battle = _queue.front();
+			_queue.pop_front();
+			lock.unlock();
+			const bool more = runSlice(*battle);
+			lock.lock();
+
+			if (more) {
+				// Бой мог вернуться в очередь, пока остальные потоки спят: будим один из них
+				_queue.push_back(battle);
+				_ready.notify_one();
+				continue;
+			}
+			// Кадр сопрограммы больше не нужен; бой и его итог остаются доступны
+			battle->coroutine = BattleCoroutine();
+			if (--_unfinished == 0)
+				_idle.notify_all();
+		}
+	}
+}
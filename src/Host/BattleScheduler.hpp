@@ -0,0 +1,83 @@
+#pragma once
+
+#include "BattleCoroutine.hpp"
+
+#include <SimulationRunner.hpp>
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace sw::host {
+
+	// Много боев на фиксированном пуле потоков. Готовые к продолжению бои стоят в общей очереди;
+	// поток берет бой из головы, выполняет не больше его бюджета ходов и ставит в хвост, пока бой не закончится.
+	// Так каждый бой продвигается по кругу и ни один не занимает поток надолго.
+	// Один бой в каждый момент выполняется только одним потоком, но разные бои — параллельно,
+	// поэтому у каждого боя должен быть свой поток вывода событий и свой источник случайных чисел:
+	// add задает бою ключ RandomSource (SimulationRunner::setRandomKey), общий std::rand не используется
+	class BattleScheduler {
+	public:
+		using BattleId = size_t;
+
+		static constexpr uint64_t kDefaultTicksPerSlice = 4;
+
+		// Ключ случайных выборов боя зависит только от randomSeed и id боя, поэтому лог боя не зависит
+		// от числа потоков и от того, какие бои идут рядом
+		explicit BattleScheduler(size_t threads = std::max<size_t>(1, std::thread::hardware_concurrency()), uint64_t randomSeed = 0);
+		// Незаконченные бои останавливаются на границе кванта
+		~BattleScheduler();
+
+		BattleScheduler(const BattleScheduler&) = delete;
+		BattleScheduler& operator=(const BattleScheduler&) = delete;
+
+		// Добавляет загруженный, еще не начатый бой; ticksPerSlice — сколько ходов подряд бой выполняет, прежде чем уступить поток
+		BattleId add(std::unique_ptr<SimulationRunner> runner, uint64_t ticksPerSlice = kDefaultTicksPerSlice);
+
+		// Ключ RandomSource, который add задает бою id
+		static uint64_t randomKey(uint64_t randomSeed, BattleId id);
+
+		// Ждет окончания всех добавленных боев
+		void wait();
+
+		size_t battleCount() const;
+
+		// Бой по id; читать состояние безопасно после wait. Законченный бой уже собран из шардов,
+		// а бой, прерванный исключением, перед чтением мира собирают SimulationRunner::gather
+		const SimulationRunner& battle(BattleId id) const;
+		SimulationRunner& battle(BattleId id);
+
+		// Исключение, которым закончился бой, или nullptr
+		std::exception_ptr error(BattleId id) const;
+
+	private:
+		struct Battle {
+			std::unique_ptr<SimulationRunner> runner;
+			BattleCoroutine coroutine;
+			uint64_t ticksPerSlice{};
+			std::exception_ptr error;
+		};
+
+		void work();
+		// Выполняет квант боя; true — бой нужно продолжить
+		static bool runSlice(Battle& battle);
+
+		mutable std::mutex _mutex;
+		std::condition_variable _ready;
+		std::condition_variable _idle;
+		// deque не перемещает элементы при добавлении: потоки держат указатели на бои
+		std::deque<Battle> _battles;
+		std::deque<Battle*> _queue;
+		size_t _unfinished{};
+		bool _stopping = false;
+		const uint64_t _randomSeed;
+		std::vector<std::thread> _threads;
+	};
+}
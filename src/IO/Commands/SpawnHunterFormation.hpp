@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstdint>
+#include <iosfwd>
+
+namespace sw::io
+{
+	// Прямоугольный строй охотников, раскладка как у SPAWN_SWORDSMAN_FORMATION
+	struct SpawnHunterFormation
+	{
+		constexpr static const char* Name = "SPAWN_HUNTER_FORMATION";
+
+		uint32_t firstUnitId{};
+		uint32_t x{};
+		uint32_t y{};
+		uint32_t width{};
+		uint32_t height{};
+		uint32_t spacing{};
+		uint32_t hp{};
+		uint32_t agility{};
+		uint32_t strength{};
+		uint32_t range{};
+
+		template <typename Visitor>
+		void visit(Visitor& visitor)
+		{
+			visitor.visit("firstUnitId", firstUnitId);
+			visitor.visit("x", x);
+			visitor.visit("y", y);
+			visitor.visit("width", width);
+			visitor.visit("height", height);
+			visitor.visit("spacing", spacing);
+			visitor.visit("hp", hp);
+			visitor.visit("agility", agility);
+			visitor.visit("strength", strength);
+			visitor.visit("range", range);
+		}
+	};
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstdint>
+#include <iosfwd>
+
+namespace sw::io
+{
+	// Прямоугольный строй мечников: width x height юнитов с шагом spacing от (x, y).
+	// Идентификаторы идут подряд от firstUnitId построчно; линия — строй с height = 1
+	struct SpawnSwordsmanFormation
+	{
+		constexpr static const char* Name = "SPAWN_SWORDSMAN_FORMATION";
+
+		uint32_t firstUnitId{};
+		uint32_t x{};
+		uint32_t y{};
+		uint32_t width{};
+		uint32_t height{};
+		uint32_t spacing{};
+		uint32_t hp{};
+		uint32_t strength{};
+
+		template <typename Visitor>
+		void visit(Visitor& visitor)
+		{
+			visitor.visit("firstUnitId", firstUnitId);
+			visitor.visit("x", x);
+			visitor.visit("y", y);
+			visitor.visit("width", width);
+			visitor.visit("height", height);
+			visitor.visit("spacing", spacing);
+			visitor.visit("hp", hp);
+			visitor.visit("strength", strength);
+		}
+	};
+}
@@ -0,0 +1,71 @@
+#include "AsyncEventWriter.hpp"
+
+#include <cstring>
+
+namespace sw
+{
+	AsyncEventWriter::AsyncEventWriter(std::ostream& stream, size_t maxQueuedBuffers) :
+			_stream(stream),
+			_pending(maxQueuedBuffers),
+			_recycled(maxQueuedBuffers)
+	{
+		_thread = std::thread([this] { run(); });
+	}
+
+	AsyncEventWriter::~AsyncEventWriter()
+	{
+		close();
+	}
+
+	AsyncEventWriter::Buffer AsyncEventWriter::takeBuffer()
+	{
+		Buffer buffer;
+		_recycled.tryPop(buffer);
+		return buffer;
+	}
+
+	void AsyncEventWriter::submit(Buffer buffer)
+	{
+		if (!buffer.empty())
+		{
+			_pending.push(std::move(buffer));
+		}
+	}
+
+	void AsyncEventWriter::close()
+	{
+		if (!_thread.joinable())
+		{
+			return;
+		}
+		// Пустой буфер — сигнал остановки
+		_pending.push(Buffer{});
+		_thread.join();
+	}
+
+	void AsyncEventWriter::run()
+	{
+		Buffer buffer;
+		while (true)
+		{
+			_pending.pop(buffer);
+			if (buffer.empty())
+			{
+				break;
+			}
+
+			const std::byte* position = buffer.data();
+			const std::byte* end = position + buffer.size();
+			while (position < end)
+			{
+				RecordHeader header;
+				std::memcpy(&header, position, sizeof(header));
+				position = header.format(_stream, header.tick, position + sizeof(header));
+			}
+
+			buffer.clear();
+			_recycled.tryPush(buffer);
+		}
+		_stream.flush();
+	}
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include "details/SpscQueue.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <thread>
+#include <vector>
+
+namespace sw
+{
+	// Поток, форматирующий и выводящий записи событий, пока симуляция считает следующий ход.
+	// Буфер — последовательность записей [RecordHeader][поля события]. Буферы выводятся в порядке отправки.
+	// В очереди не больше maxQueuedBuffers буферов: если писатель отстает, submit ждет (обратное давление)
+	class AsyncEventWriter
+	{
+	public:
+		using Buffer = std::vector<std::byte>;
+		// Выводит одну запись, возвращает указатель на следующую
+		using FormatFn = const std::byte* (*)(std::ostream& stream, uint64_t tick, const std::byte* fields);
+
+		struct RecordHeader
+		{
+			FormatFn format{};
+			uint64_t tick{};
+		};
+
+		AsyncEventWriter(std::ostream& stream, size_t maxQueuedBuffers);
+		~AsyncEventWriter();
+
+		AsyncEventWriter(const AsyncEventWriter&) = delete;
+		AsyncEventWriter& operator=(const AsyncEventWriter&) = delete;
+
+		// Пустой буфер для заполнения; по возможности берется из уже выведенных
+		Buffer takeBuffer();
+
+		// Передает непустой буфер писателю
+		void submit(Buffer buffer);
+
+		// Дожидается вывода всех отправленных буферов и останавливает поток
+		void close();
+
+	private:
+		void run();
+
+		std::ostream& _stream;
+		SpscQueue<Buffer> _pending;
+		SpscQueue<Buffer> _recycled;
+		std::thread _thread;
+	};
+}
@@ -4,30 +4,24 @@ namespace sw::io
 {
 	void CommandParser::parse(std::istream& stream)
 	{
-		std::string line;
-		while (std::getline(stream, line))
-		{
-			if (line.rfind("//", 0) == 0 || line.empty())
-			{
-				continue;
-			}
-
-			std::istringstream commandStream(line);
-			std::string commandName;
-			commandStream >> commandName;
-
-			if (commandName.empty())
-			{
-				continue;
-			}
-
-			auto command = _commands.find(commandName);
-			if (command == _commands.end())
+		forEachLine(
+			stream,
+			[this](std::string_view name, std::string_view fields)
 			{
-				throw std::runtime_error("Unknown command: " + commandName);
-			}
+				dispatchRegistered(name, fields);
+			});
+	}
 
-			command->second(commandStream);
+	void CommandParser::dispatchRegistered(std::string_view name, std::string_view fields)
+	{
+		const std::string commandName(name);
+		auto command = _commands.find(commandName);
+		if (command == _commands.end())
+		{
+			throw std::runtime_error("Unknown command: " + commandName);
 		}
+
+		std::istringstream commandStream{std::string(fields)};
+		command->second(commandStream);
 	}
 }
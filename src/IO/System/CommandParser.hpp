@@ -1,13 +1,31 @@
 #pragma once
 
 #include "details/CommandParserVisitor.hpp"
+#include "details/StringViewParserVisitor.hpp"
 
+#include <algorithm>
+#include <cstddef>
+#include <deque>
 #include <functional>
+#include <future>
 #include <sstream>
+#include <stdexcept>
 #include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <variant>
+#include <vector>
 
 namespace sw::io
 {
+	// Список команд, разбираемых без поиска по строке и без std::function
+	template <class... TCommands>
+	struct CommandList
+	{};
+
 	class CommandParser
 	{
 	private:
@@ -35,6 +53,221 @@ namespace sw::io
 			return *this;
 		}
 
+		// Только команды, зарегистрированные через add
 		void parse(std::istream& stream);
+
+		// Команды из TCommands выбираются сравнением длины и первого символа имени (константы времени компиляции)
+		// и передаются в handler(TCommand) статически. Остальные ищутся среди зарегистрированных через add
+		template <class... TCommands, class THandler>
+		void parse(std::istream& stream, CommandList<TCommands...>, THandler&& handler)
+		{
+			static_assert(hasUniqueNames<TCommands...>(), "Command names in CommandList must be unique");
+			forEachLine(
+				stream,
+				[&](std::string_view name, std::string_view fields)
+				{
+					if (!(tryDispatch<TCommands>(name, fields, handler) || ...))
+					{
+						dispatchRegistered(name, fields);
+					}
+				});
+		}
+
+		// То же для текста целиком в памяти: текст делится по границам строк на куски, которые разбираются
+		// в типизированные записи на нескольких потоках, а handler вызывается строго в порядке файла.
+		// Одновременно разбирается не больше threads кусков примерно по chunkBytes, поэтому память не зависит от размера файла
+		template <class... TCommands, class THandler>
+		void parse(
+			std::string_view text,
+			CommandList<TCommands...>,
+			THandler&& handler,
+			size_t threads = defaultParseThreads(),
+			size_t chunkBytes = kDefaultParseChunkBytes)
+		{
+			static_assert(hasUniqueNames<TCommands...>(), "Command names in CommandList must be unique");
+			using Record = std::variant<RegisteredLine, TCommands...>;
+
+			auto decodeChunk = [](std::string_view chunk)
+			{
+				std::vector<Record> records;
+				forEachLine(
+					chunk,
+					[&](std::string_view name, std::string_view fields)
+					{
+						if (!(tryDecode<TCommands>(name, fields, records) || ...))
+						{
+							records.emplace_back(RegisteredLine{name, fields});
+						}
+					});
+				return records;
+			};
+			auto applyRecords = [&](std::vector<Record>& records)
+			{
+				for (Record& record : records)
+				{
+					if (RegisteredLine* line = std::get_if<RegisteredLine>(&record))
+					{
+						dispatchRegistered(line->name, line->fields);
+					}
+					else
+					{
+						std::visit([&](auto& command) { applyDecoded(command, handler); }, record);
+					}
+				}
+			};
+
+			if (threads <= 1 || text.size() <= chunkBytes)
+			{
+				std::vector<Record> records = decodeChunk(text);
+				applyRecords(records);
+				return;
+			}
+
+			std::deque<std::future<std::vector<Record>>> inFlight;
+			size_t offset = 0;
+			auto launchNext = [&]
+			{
+				const size_t end = chunkEnd(text, offset, chunkBytes);
+				inFlight.push_back(std::async(std::launch::async, decodeChunk, text.substr(offset, end - offset)));
+				offset = end;
+			};
+			while (offset < text.size() && inFlight.size() < threads)
+			{
+				launchNext();
+			}
+			while (!inFlight.empty())
+			{
+				std::vector<Record> records = inFlight.front().get();
+				inFlight.pop_front();
+				if (offset < text.size())
+				{
+					launchNext();
+				}
+				applyRecords(records);
+			}
+		}
+
+		static size_t defaultParseThreads()
+		{
+			return std::max<size_t>(1, std::thread::hardware_concurrency());
+		}
+
+		static constexpr size_t kDefaultParseChunkBytes = 4 * 1024 * 1024;
+
+	private:
+		// Строка команды, зарегистрированной через add: разбирается при применении
+		struct RegisteredLine
+		{
+			std::string_view name;
+			std::string_view fields;
+		};
+
+		template <class TCommand, class TRecord>
+		static bool tryDecode(std::string_view name, std::string_view fields, std::vector<TRecord>& records)
+		{
+			constexpr std::string_view commandName = TCommand::Name;
+			if (name.size() != commandName.size() || name[0] != commandName[0] || name != commandName)
+			{
+				return false;
+			}
+			TCommand& data = std::get<TCommand>(records.emplace_back(std::in_place_type<TCommand>));
+			StringViewParserVisitor visitor(fields);
+			data.visit(visitor);
+			return true;
+		}
+
+		template <class TCommand, class THandler>
+		static void applyDecoded(TCommand& command, THandler& handler)
+		{
+			if constexpr (!std::is_same_v<TCommand, RegisteredLine>)
+			{
+				handler(std::move(command));
+			}
+		}
+
+		// Конец куска: первый перевод строки после offset + chunkBytes (включительно) или конец текста
+		static size_t chunkEnd(std::string_view text, size_t offset, size_t chunkBytes)
+		{
+			if (text.size() - offset <= chunkBytes)
+			{
+				return text.size();
+			}
+			const size_t newline = text.find('\n', offset + chunkBytes);
+			return newline == std::string_view::npos ? text.size() : newline + 1;
+		}
+
+		template <class TCommand, class THandler>
+		static bool tryDispatch(std::string_view name, std::string_view fields, THandler& handler)
+		{
+			constexpr std::string_view commandName = TCommand::Name;
+			if (name.size() != commandName.size() || name[0] != commandName[0] || name != commandName)
+			{
+				return false;
+			}
+			TCommand data;
+			StringViewParserVisitor visitor(fields);
+			data.visit(visitor);
+			handler(std::move(data));
+			return true;
+		}
+
+		template <class... TCommands>
+		static constexpr bool hasUniqueNames()
+		{
+			constexpr std::string_view names[] = {std::string_view(TCommands::Name)..., std::string_view()};
+			for (size_t i = 0; i < sizeof...(TCommands); ++i)
+			{
+				for (size_t j = i + 1; j < sizeof...(TCommands); ++j)
+				{
+					if (names[i] == names[j])
+					{
+						return false;
+					}
+				}
+			}
+			return true;
+		}
+
+		// Вызывает f(имя команды, остаток строки) для каждой непустой строки, кроме комментариев
+		template <class F>
+		static void forEachLine(std::istream& stream, F&& f)
+		{
+			std::string line;
+			while (std::getline(stream, line))
+			{
+				splitLine(line, f);
+			}
+		}
+
+		// То же для текста в памяти; строки делятся так же, как std::getline
+		template <class F>
+		static void forEachLine(std::string_view text, F&& f)
+		{
+			while (!text.empty())
+			{
+				const size_t newline = text.find('\n');
+				splitLine(text.substr(0, newline), f);
+				text = newline == std::string_view::npos ? std::string_view{} : text.substr(newline + 1);
+			}
+		}
+
+		template <class F>
+		static void splitLine(std::string_view line, F& f)
+		{
+			if (line.rfind("//", 0) == 0 || line.empty())
+			{
+				return;
+			}
+
+			const size_t nameStart = line.find_first_not_of(" \t\n\v\f\r");
+			if (nameStart == std::string_view::npos)
+			{
+				return;
+			}
+			const size_t nameEnd = std::min(line.find_first_of(" \t\n\v\f\r", nameStart), line.size());
+			f(line.substr(nameStart, nameEnd - nameStart), line.substr(nameEnd));
+		}
+
+		void dispatchRegistered(std::string_view name, std::string_view fields);
 	};
 }
@@ -0,0 +1,152 @@
+#pragma once
+
+#include "CommandParser.hpp"
+#include "details/RecordReadVisitor.hpp"
+#include "details/RecordWriteVisitor.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace sw::io
+{
+	// Двоичный сценарий (--compile): заголовок, затем записи команд в порядке файла.
+	// Запись: [uint8 номер типа в CommandList][uint32 длина полей][поля, RecordWriteVisitor].
+	// Версия меняется при любом изменении формата записей или состава списка команд
+	struct CompiledScenarioHeader
+	{
+		static constexpr char kMagic[8] = {'S', 'W', 'S', 'C', 'E', 'N', 'B', '\0'};
+		static constexpr uint32_t kVersion = 2;
+
+		char magic[8]{};
+		uint32_t version{};
+		uint32_t commandTypes{};
+		uint64_t recordCount{};
+	};
+
+	inline bool isCompiledScenario(const std::byte* data, size_t size)
+	{
+		return size >= sizeof(CompiledScenarioHeader)
+			&& std::memcmp(data, CompiledScenarioHeader::kMagic, sizeof(CompiledScenarioHeader::kMagic)) == 0;
+	}
+
+	template <class TCommandList>
+	class CompiledScenarioWriter;
+
+	template <class... TCommands>
+	class CompiledScenarioWriter<CommandList<TCommands...>>
+	{
+	private:
+		std::vector<std::byte> _records;
+		uint64_t _recordCount = 0;
+
+		template <class TCommand, size_t... Is>
+		static constexpr uint8_t tagOf(std::index_sequence<Is...>)
+		{
+			return static_cast<uint8_t>(((std::is_same_v<TCommand, TCommands> ? Is : 0) + ...));
+		}
+
+	public:
+		static_assert(sizeof...(TCommands) <= 255, "Too many command types for a one-byte tag");
+
+		template <class TCommand>
+		void add(TCommand command)
+		{
+			static_assert((std::is_same_v<TCommand, TCommands> || ...), "Command is not in the compiled command list");
+			RecordWriteVisitor writer(_records);
+			const uint8_t tag = tagOf<TCommand>(std::index_sequence_for<TCommands...>{});
+			writer.append(&tag, sizeof(tag));
+
+			const size_t sizeOffset = _records.size();
+			uint32_t size = 0;
+			writer.append(&size, sizeof(size));
+			command.visit(writer);
+			size = static_cast<uint32_t>(_records.size() - sizeOffset - sizeof(size));
+			std::memcpy(_records.data() + sizeOffset, &size, sizeof(size));
+			++_recordCount;
+		}
+
+		void write(std::ostream& stream) const
+		{
+			CompiledScenarioHeader header;
+			std::memcpy(header.magic, CompiledScenarioHeader::kMagic, sizeof(header.magic));
+			header.version = CompiledScenarioHeader::kVersion;
+			header.commandTypes = sizeof...(TCommands);
+			header.recordCount = _recordCount;
+			stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+			stream.write(reinterpret_cast<const char*>(_records.data()), static_cast<std::streamsize>(_records.size()));
+			if (!stream)
+			{
+				throw std::runtime_error("Failed to write compiled scenario");
+			}
+		}
+	};
+
+	// Передает команды двоичного сценария в handler(TCommand) в порядке файла.
+	// Проверяется только целостность записей: содержимое было проверено при компиляции.
+	// Записи не читаются за пределами своей длины, а длина — за пределами data + size
+	template <class... TCommands, class THandler>
+	void readCompiledScenario(const std::byte* data, size_t size, CommandList<TCommands...>, THandler&& handler)
+	{
+		if (!isCompiledScenario(data, size))
+		{
+			throw std::runtime_error("Not a compiled scenario");
+		}
+		CompiledScenarioHeader header;
+		std::memcpy(&header, data, sizeof(header));
+		if (header.version != CompiledScenarioHeader::kVersion || header.commandTypes != sizeof...(TCommands))
+		{
+			throw std::runtime_error("Compiled scenario version mismatch, recompile it with --compile");
+		}
+
+		const std::byte* position = data + sizeof(header);
+		const std::byte* end = data + size;
+		for (uint64_t record = 0; record < header.recordCount; ++record)
+		{
+			uint8_t tag{};
+			uint32_t fieldsSize{};
+			if (static_cast<size_t>(end - position) < sizeof(tag) + sizeof(fieldsSize))
+			{
+				throw std::runtime_error("Compiled scenario is truncated");
+			}
+			std::memcpy(&tag, position, sizeof(tag));
+			std::memcpy(&fieldsSize, position + sizeof(tag), sizeof(fieldsSize));
+			position += sizeof(tag) + sizeof(fieldsSize);
+			if (static_cast<size_t>(end - position) < fieldsSize || tag >= sizeof...(TCommands))
+			{
+				throw std::runtime_error("Compiled scenario is corrupted");
+			}
+
+			const std::byte* fields = position;
+			auto decode = [&]<class TCommand>()
+			{
+				TCommand command;
+				// Длина записи команды без строк известна заранее: другая длина — порча, даже если байт хватает
+				RecordSizeVisitor expected;
+				command.visit(expected);
+				if (expected.fixed() ? fieldsSize != expected.size() : fieldsSize < expected.size())
+				{
+					throw std::runtime_error("Compiled scenario is corrupted");
+				}
+				RecordReadVisitor reader(fields, fields + fieldsSize);
+				command.visit(reader);
+				if (reader.position() != fields + fieldsSize)
+				{
+					throw std::runtime_error("Compiled scenario is corrupted");
+				}
+				handler(std::move(command));
+			};
+			[&]<size_t... Is>(std::index_sequence<Is...>)
+			{
+				((tag == Is ? (decode.template operator()<TCommands>(), true) : false) || ...);
+			}(std::index_sequence_for<TCommands...>{});
+			position += fieldsSize;
+		}
+	}
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+#include <vector>
+
+namespace sw
+{
+	// Какие события попадают в лог: по типу, по юнитам и по диапазону ходов.
+	// Незаданное условие пропускает все события
+	class EventFilter
+	{
+	public:
+		// Разрешенные типы событий (их Name)
+		void allowTypes(const std::vector<std::string>& names)
+		{
+			_types.emplace(names.begin(), names.end());
+		}
+
+		// Разрешены только события, упоминающие хотя бы одного из этих юнитов
+		void allowUnits(const std::vector<uint32_t>& unitIds)
+		{
+			_units.emplace(unitIds.begin(), unitIds.end());
+		}
+
+		// Ходы [fromTick, toTick] включительно
+		void setTickRange(uint64_t fromTick, uint64_t toTick)
+		{
+			_fromTick = fromTick;
+			_toTick = toTick;
+		}
+
+		bool passesAll() const
+		{
+			return !_types && !_units && _fromTick == 0 && _toTick == std::numeric_limits<uint64_t>::max();
+		}
+
+		bool acceptsType(std::string_view name) const
+		{
+			return !_types || _types->contains(std::string(name));
+		}
+
+		bool acceptsTick(uint64_t tick) const
+		{
+			return tick >= _fromTick && tick <= _toTick;
+		}
+
+		bool filtersUnits() const
+		{
+			return _units.has_value();
+		}
+
+		bool acceptsUnit(uint32_t unitId) const
+		{
+			return !_units || _units->contains(unitId);
+		}
+
+	private:
+		std::optional<std::unordered_set<std::string>> _types;
+		std::optional<std::unordered_set<uint32_t>> _units;
+		uint64_t _fromTick{0};
+		uint64_t _toTick{std::numeric_limits<uint64_t>::max()};
+	};
+}
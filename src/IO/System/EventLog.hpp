@@ -1,22 +1,267 @@
 #pragma once
 
+#include "AsyncEventWriter.hpp"
+#include "EventFilter.hpp"
 #include "details/PrintFieldVisitor.hpp"
+#include "details/RecordReadVisitor.hpp"
+#include "details/RecordWriteVisitor.hpp"
+#include "details/UnitIdMatchVisitor.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
 #include <iostream>
-#include <typeindex>
-#include <unordered_map>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 namespace sw
 {
+	namespace details
+	{
+		inline size_t nextEventTypeIndex()
+		{
+			static size_t next = 0;
+			return next++;
+		}
+
+		// Порядковый номер типа события, назначается при запуске программы
+		template <class TEvent>
+		inline const size_t kEventTypeIndex = nextEventTypeIndex();
+	}
+
 	class EventLog
 	{
 	public:
+		// Буфер отдается писателю при смене хода или по достижении этого размера
+		static constexpr size_t kAsyncBufferBytes = 64 * 1024;
+		static constexpr size_t kDefaultQueuedBuffers = 8;
+
+		explicit EventLog(std::ostream& stream = std::cout) :
+				_stream(stream)
+		{}
+
+		~EventLog()
+		{
+			close();
+		}
+
+		EventLog(const EventLog&) = delete;
+		EventLog& operator=(const EventLog&) = delete;
+
+		// Асинхронный режим: события копируются в буфер текущего хода, а форматирует и выводит их отдельный поток.
+		// Память ограничена примерно (2 * maxQueuedBuffers + 1) * kAsyncBufferBytes
+		void enableAsync(size_t maxQueuedBuffers = kDefaultQueuedBuffers)
+		{
+			if (_writer)
+			{
+				return;
+			}
+			_writer = std::make_unique<AsyncEventWriter>(_stream, maxQueuedBuffers);
+			_buffer = _writer->takeBuffer();
+		}
+
+		// Запись без вывода: события копируются в буфер записей (формат AsyncEventWriter) и забираются
+		// через recorded. Так шард боя пишет события на своем потоке, а основной лог выводит их
+		// в нужном порядке через appendRecorded
+		void enableRecording()
+		{
+			_recording = true;
+		}
+
+		const AsyncEventWriter::Buffer& recorded() const
+		{
+			return _buffer;
+		}
+
+		void clearRecorded()
+		{
+			_buffer.clear();
+		}
+
+		// Записи [data, data + size) хода tick из лога в режиме записи; events — сколько в них событий.
+		// Фильтр уже применен при записи
+		void appendRecorded(uint64_t tick, const std::byte* data, size_t size, uint64_t events)
+		{
+			if (size == 0)
+			{
+				return;
+			}
+			_loggedEvents += events;
+			if (!_writer)
+			{
+				const std::byte* position = data;
+				while (position < data + size)
+				{
+					AsyncEventWriter::RecordHeader header;
+					std::memcpy(&header, position, sizeof(header));
+					position = header.format(_stream, header.tick, position + sizeof(header));
+				}
+				return;
+			}
+
+			if (!_buffer.empty() && (tick != _bufferTick || _buffer.size() >= kAsyncBufferBytes))
+			{
+				handOff();
+			}
+			_bufferTick = tick;
+			_buffer.insert(_buffer.end(), data, data + size);
+		}
+
+		const EventFilter& filter() const
+		{
+			return _filter;
+		}
+
+		void setFilter(EventFilter filter)
+		{
+			_filter = std::move(filter);
+			_filtered = !_filter.passesAll();
+			_typeStates.clear();
+		}
+
+		// Попадет ли событие типа TEvent хода tick в лог (без учета фильтра по юнитам).
+		// Проверяется до создания события, чтобы отключенные типы ничего не стоили
+		template <class TEvent>
+		bool enabled(uint64_t tick)
+		{
+			if (!_filtered)
+			{
+				return true;
+			}
+			if (!_filter.acceptsTick(tick))
+			{
+				return false;
+			}
+
+			const size_t index = details::kEventTypeIndex<TEvent>;
+			if (index >= _typeStates.size())
+			{
+				_typeStates.resize(index + 1, TypeState::Unknown);
+			}
+			TypeState& state = _typeStates[index];
+			if (state == TypeState::Unknown)
+			{
+				state = _filter.acceptsType(TEvent::Name) ? TypeState::Enabled : TypeState::Disabled;
+			}
+			return state == TypeState::Enabled;
+		}
+
 		template <class TEvent>
 		void log(uint64_t tick, TEvent&& event)
 		{
-			std::cout << "[" << tick << "] " << TEvent::Name << " ";
-			PrintFieldVisitor visitor(std::cout);
+			using Event = std::remove_cvref_t<TEvent>;
+			if (_filtered)
+			{
+				if (!enabled<Event>(tick))
+				{
+					return;
+				}
+				if (_filter.filtersUnits())
+				{
+					UnitIdMatchVisitor matcher(_filter);
+					event.visit(matcher);
+					if (!matcher.matched())
+					{
+						return;
+					}
+				}
+			}
+
+			++_loggedEvents;
+			if (_recording)
+			{
+				appendRecord(tick, event);
+				return;
+			}
+			if (!_writer)
+			{
+				print(_stream, tick, event);
+				return;
+			}
+
+			if (!_buffer.empty() && (tick != _bufferTick || _buffer.size() >= kAsyncBufferBytes))
+			{
+				handOff();
+			}
+			_bufferTick = tick;
+			appendRecord(tick, event);
+		}
+
+		// Событий, прошедших фильтр, с создания лога
+		uint64_t loggedEvents() const
+		{
+			return _loggedEvents;
+		}
+
+		// Выводит все залогированные события; после этого лог снова синхронный
+		void close()
+		{
+			if (_recording)
+			{
+				return;
+			}
+			if (_writer)
+			{
+				handOff();
+				_writer->close();
+				_writer.reset();
+			}
+			_stream.flush();
+		}
+
+	private:
+		template <class TEvent>
+		static void print(std::ostream& stream, uint64_t tick, TEvent& event)
+		{
+			stream << "[" << tick << "] " << TEvent::Name << " ";
+			PrintFieldVisitor visitor(stream);
 			event.visit(visitor);
-			std::cout << std::endl;
+			stream << '\n';
+		}
+
+		template <class TEvent>
+		void appendRecord(uint64_t tick, TEvent& event)
+		{
+			RecordWriteVisitor writer(_buffer);
+			const AsyncEventWriter::RecordHeader header{&formatRecord<std::remove_cvref_t<TEvent>>, tick};
+			writer.append(&header, sizeof(header));
+			event.visit(writer);
+		}
+
+		template <class TEvent>
+		static const std::byte* formatRecord(std::ostream& stream, uint64_t tick, const std::byte* fields)
+		{
+			TEvent event;
+			RecordReadVisitor reader(fields);
+			event.visit(reader);
+			print(stream, tick, event);
+			return reader.position();
+		}
+
+		void handOff()
+		{
+			_writer->submit(std::move(_buffer));
+			_buffer = _writer->takeBuffer();
 		}
+
+		enum class TypeState : uint8_t
+		{
+			Unknown,
+			Enabled,
+			Disabled,
+		};
+
+		std::ostream& _stream;
+		EventFilter _filter;
+		bool _filtered = false;
+		bool _recording = false;
+		// Кеш решения фильтра по типу события, индекс — details::kEventTypeIndex
+		std::vector<TypeState> _typeStates;
+		std::unique_ptr<AsyncEventWriter> _writer;
+		AsyncEventWriter::Buffer _buffer;
+		uint64_t _bufferTick{};
+		uint64_t _loggedEvents{};
 	};
 }
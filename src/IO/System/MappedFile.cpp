@@ -0,0 +1,69 @@
+#include "MappedFile.hpp"
+
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define SW_HAS_MMAP 1
+#endif
+
+namespace sw::io
+{
+	MappedFile::MappedFile(const std::string& path)
+	{
+#ifdef SW_HAS_MMAP
+		const int fd = ::open(path.c_str(), O_RDONLY);
+		if (fd < 0)
+		{
+			throw std::runtime_error("Error: File not found - " + path);
+		}
+		struct stat info{};
+		if (::fstat(fd, &info) != 0)
+		{
+			::close(fd);
+			throw std::runtime_error("Error: Cannot stat file - " + path);
+		}
+		_size = static_cast<size_t>(info.st_size);
+		if (_size > 0)
+		{
+			void* mapping = ::mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, fd, 0);
+			if (mapping != MAP_FAILED)
+			{
+				_data = static_cast<const std::byte*>(mapping);
+				_mapped = true;
+			}
+		}
+		::close(fd);
+		if (_mapped || _size == 0)
+		{
+			return;
+		}
+#endif
+		std::ifstream file(path, std::ios::binary);
+		if (!file)
+		{
+			throw std::runtime_error("Error: File not found - " + path);
+		}
+		file.seekg(0, std::ios::end);
+		_fallback.resize(static_cast<size_t>(file.tellg()));
+		file.seekg(0, std::ios::beg);
+		file.read(reinterpret_cast<char*>(_fallback.data()), static_cast<std::streamsize>(_fallback.size()));
+		_data = _fallback.data();
+		_size = _fallback.size();
+	}
+
+	MappedFile::~MappedFile()
+	{
+#ifdef SW_HAS_MMAP
+		if (_mapped)
+		{
+			::munmap(const_cast<std::byte*>(_data), _size);
+		}
+#endif
+	}
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace sw::io
+{
+	// Файл, отображенный в память только для чтения (mmap).
+	// Где mmap недоступен, файл читается в память целиком
+	class MappedFile
+	{
+	public:
+		explicit MappedFile(const std::string& path);
+		~MappedFile();
+
+		MappedFile(const MappedFile&) = delete;
+		MappedFile& operator=(const MappedFile&) = delete;
+
+		const std::byte* data() const
+		{
+			return _data;
+		}
+
+		size_t size() const
+		{
+			return _size;
+		}
+
+	private:
+		const std::byte* _data = nullptr;
+		size_t _size = 0;
+		bool _mapped = false;
+		std::vector<std::byte> _fallback;
+	};
+}
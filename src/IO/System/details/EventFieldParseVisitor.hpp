@@ -0,0 +1,52 @@
+#pragma once
+
+#include <charconv>
+#include <istream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+namespace sw
+{
+	// Разбирает поля события из строки лога в формате PrintFieldVisitor: "name=value name=value "
+	class EventFieldParseVisitor
+	{
+	private:
+		std::istream& _stream;
+
+	public:
+		explicit EventFieldParseVisitor(std::istream& stream) :
+				_stream(stream)
+		{}
+
+		template <class TField>
+		void visit(const char* name, TField& field)
+		{
+			static_assert(std::is_integral_v<TField>, "Unsupported event field type");
+			const std::string value = readValue(name);
+			const auto [end, error] = std::from_chars(value.data(), value.data() + value.size(), field);
+			if (error != std::errc{} || end != value.data() + value.size())
+			{
+				throw std::runtime_error("Invalid value of event field " + std::string(name) + ": " + value);
+			}
+		}
+
+		void visit(const char* name, std::string& field)
+		{
+			field = readValue(name);
+		}
+
+	private:
+		std::string readValue(const char* name)
+		{
+			std::string token;
+			_stream >> token;
+			const size_t eq = token.find('=');
+			if (eq == std::string::npos || token.compare(0, eq, name) != 0)
+			{
+				throw std::runtime_error("Expected event field " + std::string(name) + ", got: " + token);
+			}
+			return token.substr(eq + 1);
+		}
+	};
+}
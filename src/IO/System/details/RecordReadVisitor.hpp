@@ -0,0 +1,98 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+namespace sw
+{
+	// Читает поля события, записанные RecordWriteVisitor, в том же порядке
+	class RecordReadVisitor
+	{
+	private:
+		const std::byte* _position;
+		// Конец доступных байт; nullptr — буфер записан этим же процессом и заведомо цел
+		const std::byte* _end = nullptr;
+
+	public:
+		explicit RecordReadVisitor(const std::byte* position) :
+				_position(position)
+		{}
+
+		// Чтение за пределы [position, end) — исключение до копирования
+		RecordReadVisitor(const std::byte* position, const std::byte* end) :
+				_position(position),
+				_end(end)
+		{}
+
+		template <class TField>
+		void visit(const char*, TField& field)
+		{
+			read(&field, sizeof(field));
+		}
+
+		void visit(const char*, std::string& field)
+		{
+			uint32_t size{};
+			read(&size, sizeof(size));
+			require(size);
+			field.assign(reinterpret_cast<const char*>(_position), size);
+			_position += size;
+		}
+
+		void read(void* data, size_t size)
+		{
+			require(size);
+			std::memcpy(data, _position, size);
+			_position += size;
+		}
+
+		const std::byte* position() const
+		{
+			return _position;
+		}
+
+	private:
+		void require(size_t size) const
+		{
+			if (_end && static_cast<size_t>(_end - _position) < size)
+			{
+				throw std::runtime_error("Record is truncated");
+			}
+		}
+	};
+
+	// Размер полей записи, если он не зависит от значений (нет строк)
+	class RecordSizeVisitor
+	{
+	private:
+		size_t _size = 0;
+		bool _fixed = true;
+
+	public:
+		template <class TField>
+		void visit(const char*, const TField&)
+		{
+			_size += sizeof(TField);
+		}
+
+		void visit(const char*, const std::string&)
+		{
+			_size += sizeof(uint32_t);
+			_fixed = false;
+		}
+
+		// Для записей со строками — наименьший размер (все строки пустые)
+		size_t size() const
+		{
+			return _size;
+		}
+
+		bool fixed() const
+		{
+			return _fixed;
+		}
+	};
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace sw
+{
+	// Дописывает поля события в буфер в двоичном виде: числа — как есть, строки — длина и байты
+	class RecordWriteVisitor
+	{
+	private:
+		std::vector<std::byte>& _buffer;
+
+	public:
+		explicit RecordWriteVisitor(std::vector<std::byte>& buffer) :
+				_buffer(buffer)
+		{}
+
+		template <class TField>
+		void visit(const char*, const TField& field)
+		{
+			static_assert(std::is_trivially_copyable_v<TField>, "Unsupported event field type");
+			append(&field, sizeof(field));
+		}
+
+		void visit(const char*, const std::string& field)
+		{
+			const uint32_t size = static_cast<uint32_t>(field.size());
+			append(&size, sizeof(size));
+			append(field.data(), field.size());
+		}
+
+		void append(const void* data, size_t size)
+		{
+			const size_t offset = _buffer.size();
+			_buffer.resize(offset + size);
+			std::memcpy(_buffer.data() + offset, data, size);
+		}
+	};
+}
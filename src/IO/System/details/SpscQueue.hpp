@@ -0,0 +1,82 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace sw
+{
+	// Ограниченная очередь без блокировок для одного писателя и одного читателя.
+	// push и pop ждут (std::atomic::wait), когда очередь полна или пуста
+	template <class T>
+	class SpscQueue
+	{
+	public:
+		explicit SpscQueue(size_t capacity) :
+				_slots(capacity + 1)
+		{}
+
+		bool tryPush(T& value)
+		{
+			const size_t tail = _tail.load(std::memory_order_relaxed);
+			const size_t next = advance(tail);
+			if (next == _head.load(std::memory_order_acquire))
+			{
+				return false;
+			}
+			_slots[tail] = std::move(value);
+			_tail.store(next, std::memory_order_release);
+			_tail.notify_one();
+			return true;
+		}
+
+		void push(T value)
+		{
+			while (!tryPush(value))
+			{
+				const size_t head = _head.load(std::memory_order_acquire);
+				if (advance(_tail.load(std::memory_order_relaxed)) == head)
+				{
+					_head.wait(head, std::memory_order_acquire);
+				}
+			}
+		}
+
+		bool tryPop(T& value)
+		{
+			const size_t head = _head.load(std::memory_order_relaxed);
+			if (head == _tail.load(std::memory_order_acquire))
+			{
+				return false;
+			}
+			value = std::move(_slots[head]);
+			_head.store(advance(head), std::memory_order_release);
+			_head.notify_one();
+			return true;
+		}
+
+		void pop(T& value)
+		{
+			while (!tryPop(value))
+			{
+				const size_t tail = _tail.load(std::memory_order_acquire);
+				if (tail == _head.load(std::memory_order_relaxed))
+				{
+					_tail.wait(tail, std::memory_order_acquire);
+				}
+			}
+		}
+
+	private:
+		size_t advance(size_t index) const
+		{
+			return index + 1 == _slots.size() ? 0 : index + 1;
+		}
+
+		std::vector<T> _slots;
+		// Индексы на разных кеш-линиях, чтобы потоки не мешали друг другу
+		alignas(64) std::atomic<size_t> _head{0};
+		alignas(64) std::atomic<size_t> _tail{0};
+	};
+}
@@ -0,0 +1,130 @@
+#pragma once
+
+#include <cctype>
+#include <cstddef>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+namespace sw
+{
+	// Разбор полей команды прямо из строки, без std::istringstream.
+	// Повторяет поведение CommandParserVisitor (operator>>): пробелы пропускаются, для беззнаковых
+	// допускается минус с переполнением по модулю, неразобранное число дает 0,
+	// а после первой ошибки или конца строки остальные поля не изменяются
+	class StringViewParserVisitor
+	{
+	private:
+		std::string_view _text;
+		size_t _position = 0;
+		bool _failed = false;
+
+	public:
+		explicit StringViewParserVisitor(std::string_view text) :
+				_text(text)
+		{}
+
+		template <class TField>
+		void visit(const char*, TField& field)
+		{
+			static_assert(std::is_integral_v<TField> && !std::is_same_v<TField, bool>, "Unsupported command field type");
+			if (_failed || !parseInteger(field))
+			{
+				_failed = true;
+			}
+		}
+
+		void visit(const char*, std::string& field)
+		{
+			if (_failed)
+			{
+				return;
+			}
+			skipSpaces();
+			const size_t start = _position;
+			while (_position < _text.size() && !isSpace(_text[_position]))
+			{
+				++_position;
+			}
+			if (start == _position)
+			{
+				_failed = true;
+				return;
+			}
+			field.assign(_text.substr(start, _position - start));
+		}
+
+	private:
+		static bool isSpace(char c)
+		{
+			return std::isspace(static_cast<unsigned char>(c)) != 0;
+		}
+
+		void skipSpaces()
+		{
+			while (_position < _text.size() && isSpace(_text[_position]))
+			{
+				++_position;
+			}
+		}
+
+		template <class TField>
+		bool parseInteger(TField& field)
+		{
+			using Unsigned = std::make_unsigned_t<TField>;
+			skipSpaces();
+			if (_position == _text.size())
+			{
+				return false;
+			}
+			field = 0;
+			bool negative = false;
+			if (_position < _text.size() && (_text[_position] == '-' || _text[_position] == '+'))
+			{
+				negative = _text[_position] == '-';
+				++_position;
+			}
+
+			// Модуль не больше limit: для знаковых отрицательные допускают на единицу больше
+			Unsigned limit = std::numeric_limits<Unsigned>::max();
+			if constexpr (std::is_signed_v<TField>)
+			{
+				limit = static_cast<Unsigned>(std::numeric_limits<TField>::max()) + (negative ? 1 : 0);
+			}
+
+			Unsigned value = 0;
+			bool overflow = false;
+			const size_t digitsStart = _position;
+			while (_position < _text.size() && _text[_position] >= '0' && _text[_position] <= '9')
+			{
+				const Unsigned digit = static_cast<Unsigned>(_text[_position] - '0');
+				if (value > (limit - digit) / 10)
+				{
+					overflow = true;
+				}
+				value = static_cast<Unsigned>(value * 10 + digit);
+				++_position;
+			}
+			if (_position == digitsStart)
+			{
+				return false;
+			}
+
+			if (overflow)
+			{
+				if constexpr (std::is_signed_v<TField>)
+				{
+					field = negative ? std::numeric_limits<TField>::min() : std::numeric_limits<TField>::max();
+				}
+				else
+				{
+					field = std::numeric_limits<TField>::max();
+				}
+				return false;
+			}
+			field = static_cast<TField>(negative ? static_cast<Unsigned>(0 - value) : value);
+			return true;
+		}
+	};
+}
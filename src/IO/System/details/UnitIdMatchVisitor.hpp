@@ -0,0 +1,41 @@
+#pragma once
+
+#include "../EventFilter.hpp"
+
+#include <cstdint>
+#include <string_view>
+
+namespace sw
+{
+	// Проверяет, упоминает ли событие разрешенного фильтром юнита.
+	// Идентификаторы юнитов — поля unitId и *UnitId (attackerUnitId, targetUnitId)
+	class UnitIdMatchVisitor
+	{
+	private:
+		const EventFilter& _filter;
+		bool _matched = false;
+
+	public:
+		explicit UnitIdMatchVisitor(const EventFilter& filter) :
+				_filter(filter)
+		{}
+
+		template <class TField>
+		void visit(const char*, const TField&)
+		{}
+
+		void visit(const char* name, const uint32_t& field)
+		{
+			const std::string_view fieldName(name);
+			if ((fieldName == "unitId" || fieldName.ends_with("UnitId")) && _filter.acceptsUnit(field))
+			{
+				_matched = true;
+			}
+		}
+
+		bool matched() const
+		{
+			return _matched;
+		}
+	};
+}
@@ -0,0 +1,34 @@
+#include "AnsiRenderer.hpp"
+
+#include <Core/World.hpp>
+
+namespace sw::render {
+
+	void AnsiRenderer::begin(uint64_t tick, const core::World& world) {
+		// Очистка экрана; пустые клетки уже пустые, рисуем только юнитов
+		_stream << "\x1b[2J";
+		for (const auto& unit : world.unitsInCreationOrder()) {
+			if (unit && unit->blocksCell())
+				drawCell(world, unit->position());
+		}
+		drawStatus(tick, world);
+	}
+
+	void AnsiRenderer::renderTick(uint64_t tick, const core::World& world, std::vector<core::Coord> dirty) {
+		normalizeDirtyCells(dirty);
+		for (const core::Coord& c : dirty)
+			drawCell(world, c);
+		drawStatus(tick, world);
+	}
+
+	void AnsiRenderer::drawCell(const core::World& world, const core::Coord& c) {
+		const core::Unit* unit = world.unitAt(c);
+		const char glyph = unit && !unit->typeName().empty() ? unit->typeName().front() : ' ';
+		_stream << "\x1b[" << (int64_t{c.y} + 1) << ';' << (int64_t{c.x} + 1) << 'H' << glyph;
+	}
+
+	void AnsiRenderer::drawStatus(uint64_t tick, const core::World& world) {
+		_stream << "\x1b[" << (uint64_t{world.map().height()} + 2) << ";1H\x1b[2Ktick " << tick << " alive " << world.aliveUnitsCount();
+		_stream.flush();
+	}
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+#include "IRenderer.hpp"
+
+#include <ostream>
+
+namespace sw::render {
+
+	// Вывод в терминал управляющими последовательностями ANSI: начальный кадр рисует только занятые клетки,
+	// дальше каждый ход перерисовываются лишь изменившиеся. Юнит — первая буква типа, пустая клетка — пробел
+	class AnsiRenderer : public IRenderer {
+	public:
+		explicit AnsiRenderer(std::ostream& stream)
+			: _stream(stream)
+		{}
+
+		void begin(uint64_t tick, const core::World& world) override;
+		void renderTick(uint64_t tick, const core::World& world, std::vector<core::Coord> dirty) override;
+
+	private:
+		void drawCell(const core::World& world, const core::Coord& c);
+		void drawStatus(uint64_t tick, const core::World& world);
+
+		std::ostream& _stream;
+	};
+}
@@ -0,0 +1,14 @@
+#include "IRenderer.hpp"
+
+#include <algorithm>
+#include <tuple>
+
+namespace sw::render {
+
+	void normalizeDirtyCells(std::vector<core::Coord>& cells) {
+		std::sort(cells.begin(), cells.end(), [](const core::Coord& a, const core::Coord& b) {
+			return std::tie(a.y, a.x) < std::tie(b.y, b.x);
+		});
+		cells.erase(std::unique(cells.begin(), cells.end()), cells.end());
+	}
+}
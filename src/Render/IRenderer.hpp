@@ -0,0 +1,28 @@
+#pragma once
+
+#include <Core/Coord.hpp>
+
+#include <cstdint>
+#include <vector>
+
+namespace sw::core {
+	class World;
+}
+
+namespace sw::render {
+
+	// Отрисовка карты по ходам. Стоимость хода должна зависеть от числа изменившихся клеток, а не от размера карты
+	class IRenderer {
+	public:
+		virtual ~IRenderer() = default;
+
+		// Начальный кадр после загрузки сценария
+		virtual void begin(uint64_t tick, const core::World& world) = 0;
+
+		// Кадр после хода tick; dirty — изменившиеся клетки, возможно с повторами
+		virtual void renderTick(uint64_t tick, const core::World& world, std::vector<core::Coord> dirty) = 0;
+	};
+
+	// Упорядочивает клетки построчно и убирает повторы
+	void normalizeDirtyCells(std::vector<core::Coord>& cells);
+}
@@ -0,0 +1,73 @@
+#include "PpmRenderer.hpp"
+
+#include <Core/World.hpp>
+
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+namespace sw::render {
+
+	PpmRenderer::PpmRenderer(std::string prefix, uint64_t fullFrameInterval)
+		: _prefix(std::move(prefix))
+		, _fullFrameInterval(fullFrameInterval)
+		, _deltas(_prefix + ".delta", std::ios::trunc)
+	{
+		if (!_deltas)
+			throw std::runtime_error("Error: Cannot write file - " + _prefix + ".delta");
+		if (_fullFrameInterval == 0)
+			throw std::runtime_error("PPM full frame interval must be positive");
+	}
+
+	PpmRenderer::Color PpmRenderer::cellColor(const core::World& world, const core::Coord& c) {
+		const core::Unit* unit = world.unitAt(c);
+		if (!unit)
+			return {0, 0, 0};
+		if (unit->typeName() == "Swordsman")
+			return {220, 60, 60};
+		if (unit->typeName() == "Hunter")
+			return {60, 200, 60};
+		return {220, 220, 220};
+	}
+
+	void PpmRenderer::begin(uint64_t tick, const core::World& world) {
+		writeFullFrame(tick, world);
+	}
+
+	void PpmRenderer::renderTick(uint64_t tick, const core::World& world, std::vector<core::Coord> dirty) {
+		if (tick - _lastFullFrame >= _fullFrameInterval)
+			writeFullFrame(tick, world);
+
+		normalizeDirtyCells(dirty);
+		_deltas << "TICK " << tick << ' ' << dirty.size() << '\n';
+		for (const core::Coord& c : dirty) {
+			const Color color = cellColor(world, c);
+			_deltas << c.x << ' ' << c.y << ' ' << int{color[0]} << ' ' << int{color[1]} << ' ' << int{color[2]} << '\n';
+		}
+	}
+
+	// Единственное место, где стоимость пропорциональна площади карты; вызывается редко
+	void PpmRenderer::writeFullFrame(uint64_t tick, const core::World& world) {
+		const std::string path = _prefix + "_" + std::to_string(tick) + ".ppm";
+		std::ofstream frame(path, std::ios::binary | std::ios::trunc);
+		if (!frame)
+			throw std::runtime_error("Error: Cannot write file - " + path);
+
+		const uint32_t width = world.map().width();
+		const uint32_t height = world.map().height();
+		frame << "P6\n" << width << ' ' << height << "\n255\n";
+		std::vector<uint8_t> row(static_cast<size_t>(width) * 3);
+		for (uint32_t y = 0; y < height; ++y) {
+			std::fill(row.begin(), row.end(), uint8_t{0});
+			world.map().forEachOccupiedInRect(
+				core::Coord{0, static_cast<int32_t>(y)},
+				core::Coord{static_cast<int32_t>(width - 1), static_cast<int32_t>(y)},
+				[&](const core::Coord& c, int32_t) {
+					const Color color = cellColor(world, c);
+					std::copy(color.begin(), color.end(), row.begin() + static_cast<ptrdiff_t>(c.x) * 3);
+				});
+			frame.write(reinterpret_cast<const char*>(row.data()), static_cast<std::streamsize>(row.size()));
+		}
+		_lastFullFrame = tick;
+	}
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include "IRenderer.hpp"
+
+#include <array>
+#include <cstdint>
+#include <fstream>
+#include <string>
+
+namespace sw::render {
+
+	// Полный кадр <prefix>_<tick>.ppm (P6) раз в fullFrameInterval ходов и построчные изменения
+	// в текстовом файле <prefix>.delta:
+	//   TICK <tick> <количество клеток>
+	//   <x> <y> <r> <g> <b>
+	class PpmRenderer : public IRenderer {
+	public:
+		static constexpr uint64_t kDefaultFullFrameInterval = 100;
+
+		PpmRenderer(std::string prefix, uint64_t fullFrameInterval = kDefaultFullFrameInterval);
+
+		void begin(uint64_t tick, const core::World& world) override;
+		void renderTick(uint64_t tick, const core::World& world, std::vector<core::Coord> dirty) override;
+
+	private:
+		using Color = std::array<uint8_t, 3>;
+
+		static Color cellColor(const core::World& world, const core::Coord& c);
+		void writeFullFrame(uint64_t tick, const core::World& world);
+
+		std::string _prefix;
+		uint64_t _fullFrameInterval{};
+		uint64_t _lastFullFrame{};
+		std::ofstream _deltas;
+	};
+}
@@ -0,0 +1,237 @@
+#include "KeyframeIndex.hpp"
+
+#include <IO/System/details/EventFieldParseVisitor.hpp>
+
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string_view>
+#include <unordered_map>
+
+namespace sw::replay {
+
+	namespace {
+		constexpr char kMagic[8] = {'S', 'W', 'R', 'I', 'D', 'X', '2', '\0'};
+
+		// Лог узнается по размеру и хешу содержимого: логи разных боев часто совпадают по размеру
+		struct Header {
+			char magic[8]{};
+			uint64_t logSize{};
+			uint64_t logHash{};
+			uint64_t interval{};
+		};
+
+		using ApplyFn = void (*)(std::istream& fields, ReplayState& state);
+
+		template <class TEvent>
+		void applyEvent(std::istream& fields, ReplayState& state) {
+			TEvent event;
+			EventFieldParseVisitor visitor(fields);
+			event.visit(visitor);
+			state.apply(event);
+		}
+
+		const std::unordered_map<std::string_view, ApplyFn>& eventAppliers() {
+			static const std::unordered_map<std::string_view, ApplyFn> appliers{
+				{io::MapCreated::Name, &applyEvent<io::MapCreated>},
+				{io::UnitSpawned::Name, &applyEvent<io::UnitSpawned>},
+				{io::UnitMoved::Name, &applyEvent<io::UnitMoved>},
+				{io::UnitAttacked::Name, &applyEvent<io::UnitAttacked>},
+				{io::UnitDied::Name, &applyEvent<io::UnitDied>},
+				{io::MarchStarted::Name, &applyEvent<io::MarchStarted>},
+				{io::MarchEnded::Name, &applyEvent<io::MarchEnded>},
+			};
+			return appliers;
+		}
+
+		uint64_t fileSize(const std::string& path) {
+			std::error_code error;
+			const auto size = std::filesystem::file_size(path, error);
+			return error ? 0 : static_cast<uint64_t>(size);
+		}
+
+		// FNV-1a по всем байтам файла; 0, если файл не читается
+		uint64_t fileHash(const std::string& path) {
+			std::ifstream file(path, std::ios::binary);
+			if (!file)
+				return 0;
+			uint64_t hash = 14695981039346656037ull;
+			std::vector<char> chunk(64 * 1024);
+			while (file.read(chunk.data(), static_cast<std::streamsize>(chunk.size())) || file.gcount() > 0) {
+				const auto read = static_cast<size_t>(file.gcount());
+				for (size_t i = 0; i < read; ++i) {
+					hash ^= static_cast<unsigned char>(chunk[i]);
+					hash *= 1099511628211ull;
+				}
+			}
+			return hash;
+		}
+
+		template <class T>
+		void writePod(std::ostream& stream, const T& value) {
+			stream.write(reinterpret_cast<const char*>(&value), sizeof(value));
+		}
+
+		template <class T>
+		bool readPod(std::istream& stream, T& value) {
+			return static_cast<bool>(stream.read(reinterpret_cast<char*>(&value), sizeof(value)));
+		}
+	}
+
+	uint64_t logLineTick(const std::string& line) {
+		const size_t close = line.find(']');
+		uint64_t tick{};
+		if (line.empty() || line[0] != '[' || close == std::string::npos
+			|| std::from_chars(line.data() + 1, line.data() + close, tick).ptr != line.data() + close)
+			throw std::runtime_error("Replay: not an event log line: " + line);
+		return tick;
+	}
+
+	uint64_t applyLogLine(const std::string& line, ReplayState& state) {
+		const uint64_t tick = logLineTick(line);
+		std::istringstream fields(line.substr(line.find(']') + 1));
+		std::string name;
+		fields >> name;
+		auto applier = eventAppliers().find(name);
+		if (applier == eventAppliers().end())
+			throw std::runtime_error("Replay: unknown event " + name);
+		state.setTick(tick);
+		applier->second(fields, state);
+		return tick;
+	}
+
+	KeyframeIndex KeyframeIndex::build(const std::string& logPath, uint64_t interval) {
+		if (interval == 0)
+			throw std::runtime_error("Replay: keyframe interval must be positive");
+		std::ifstream log(logPath, std::ios::binary);
+		if (!log)
+			throw std::runtime_error("Replay: cannot open log " + logPath);
+		const std::string indexPath = indexPathFor(logPath);
+		std::ofstream index(indexPath, std::ios::binary | std::ios::trunc);
+		if (!index)
+			throw std::runtime_error("Replay: cannot write index " + indexPath);
+
+		Header header;
+		std::memcpy(header.magic, kMagic, sizeof(kMagic));
+		header.logSize = fileSize(logPath);
+		header.logHash = fileHash(logPath);
+		header.interval = interval;
+		writePod(index, header);
+
+		KeyframeIndex result;
+		result._logPath = logPath;
+		ReplayState state;
+		std::vector<std::byte> frame;
+		uint64_t frameOffset = sizeof(Header);
+		uint64_t nextKeyframe = interval;
+		uint64_t offset = 0;
+		std::string line;
+		while (std::getline(log, line)) {
+			const uint64_t lineStart = offset;
+			offset += line.size() + 1;
+			if (line.empty())
+				continue;
+
+			// Кадр пишется на границе ходов, когда все события хода уже применены
+			const uint64_t tick = logLineTick(line);
+			if (tick != state.tick() && state.tick() >= nextKeyframe) {
+				frame.clear();
+				state.serialize(frame);
+				index.write(reinterpret_cast<const char*>(frame.data()), static_cast<std::streamsize>(frame.size()));
+				result._entries.push_back(Entry{state.tick(), lineStart, frameOffset, frame.size()});
+				frameOffset += frame.size();
+				nextKeyframe = state.tick() + interval;
+			}
+			applyLogLine(line, state);
+		}
+
+		for (const Entry& entry : result._entries)
+			writePod(index, entry);
+		writePod(index, static_cast<uint64_t>(result._entries.size()));
+		if (!index.flush())
+			throw std::runtime_error("Replay: failed to write index " + indexPath);
+		return result;
+	}
+
+	std::optional<KeyframeIndex> KeyframeIndex::open(const std::string& logPath, uint64_t interval) {
+		const std::string indexPath = indexPathFor(logPath);
+		std::ifstream index(indexPath, std::ios::binary);
+		Header header;
+		if (!index || !readPod(index, header) || std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0)
+			return std::nullopt;
+		const uint64_t logSize = fileSize(logPath);
+		if (header.logSize != logSize || header.interval != interval || header.logHash != fileHash(logPath))
+			return std::nullopt;
+
+		// Таблица кадров и число кадров в конце файла; кадры — между заголовком и таблицей
+		const uint64_t indexSize = fileSize(indexPath);
+		uint64_t count{};
+		if (indexSize < sizeof(Header) + sizeof(count)
+			|| !index.seekg(-static_cast<std::streamoff>(sizeof(count)), std::ios::end) || !readPod(index, count))
+			return std::nullopt;
+		if (count > (indexSize - sizeof(Header) - sizeof(count)) / sizeof(Entry))
+			return std::nullopt;
+		const uint64_t tableStart = indexSize - sizeof(count) - count * sizeof(Entry);
+		if (!index.seekg(static_cast<std::streamoff>(tableStart)))
+			return std::nullopt;
+
+		KeyframeIndex result;
+		result._logPath = logPath;
+		result._entries.resize(count);
+		uint64_t previousTick = 0;
+		for (Entry& entry : result._entries) {
+			if (!readPod(index, entry))
+				return std::nullopt;
+			const bool frameInside = entry.frameOffset >= sizeof(Header) && entry.frameOffset <= tableStart
+				&& entry.frameSize <= tableStart - entry.frameOffset;
+			if (!frameInside || entry.logOffset > logSize || entry.tick < previousTick)
+				return std::nullopt;
+			previousTick = entry.tick;
+		}
+		return result;
+	}
+
+	ReplayState KeyframeIndex::seek(uint64_t tick) const {
+		ReplayState state;
+		uint64_t logOffset = 0;
+
+		auto after = std::upper_bound(_entries.begin(), _entries.end(), tick, [](uint64_t value, const Entry& entry) {
+			return value < entry.tick;
+		});
+		if (after != _entries.begin()) {
+			const Entry& entry = *(after - 1);
+			std::ifstream index(indexPathFor(_logPath), std::ios::binary);
+			std::vector<std::byte> frame(entry.frameSize);
+			if (!index.seekg(static_cast<std::streamoff>(entry.frameOffset))
+				|| !index.read(reinterpret_cast<char*>(frame.data()), static_cast<std::streamsize>(frame.size())))
+				throw std::runtime_error("Replay: failed to read keyframe");
+			state = ReplayState::deserialize(frame.data(), frame.size());
+			logOffset = entry.logOffset;
+		}
+
+		std::ifstream log(_logPath, std::ios::binary);
+		if (!log || !log.seekg(static_cast<std::streamoff>(logOffset)))
+			throw std::runtime_error("Replay: cannot open log " + _logPath);
+		std::string line;
+		while (std::getline(log, line)) {
+			if (line.empty())
+				continue;
+			if (logLineTick(line) > tick)
+				break;
+			applyLogLine(line, state);
+		}
+		state.setTick(tick);
+		return state;
+	}
+
+	ReplayState seekReplay(const std::string& logPath, uint64_t tick, uint64_t interval) {
+		std::optional<KeyframeIndex> index = KeyframeIndex::open(logPath, interval);
+		if (!index)
+			index = KeyframeIndex::build(logPath, interval);
+		return index->seek(tick);
+	}
+}
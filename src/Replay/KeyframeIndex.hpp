@@ -0,0 +1,57 @@
+#pragma once
+
+#include "ReplayState.hpp"
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace sw::replay {
+
+	// Индекс ключевых кадров к логу событий (файл <лог>.idx рядом с логом).
+	// Кадр — снимок ReplayState на конец хода и смещение в логе первой строки следующего хода.
+	// Переход к ходу T: загрузка последнего кадра с тиком <= T и применение событий не более чем interval ходов
+	class KeyframeIndex {
+	public:
+		static constexpr uint64_t kDefaultInterval = 256;
+
+		static std::string indexPathFor(const std::string& logPath) {
+			return logPath + ".idx";
+		}
+
+		// Проигрывает лог целиком и записывает кадры не реже чем раз в interval ходов
+		static KeyframeIndex build(const std::string& logPath, uint64_t interval);
+
+		// Загружает индекс; nullopt, если его нет, он поврежден, построен по другому содержимому лога
+		// (размер и хеш всех байт) или с другим интервалом
+		static std::optional<KeyframeIndex> open(const std::string& logPath, uint64_t interval);
+
+		// Состояние мира на конец хода tick
+		ReplayState seek(uint64_t tick) const;
+
+		size_t keyframeCount() const {
+			return _entries.size();
+		}
+
+	private:
+		struct Entry {
+			uint64_t tick{};
+			uint64_t logOffset{};
+			uint64_t frameOffset{};
+			uint64_t frameSize{};
+		};
+
+		std::string _logPath;
+		std::vector<Entry> _entries;
+	};
+
+	// Применяет строку лога "[tick] NAME field=value ..." к состоянию, возвращает ход строки
+	uint64_t applyLogLine(const std::string& line, ReplayState& state);
+
+	// Ход строки лога
+	uint64_t logLineTick(const std::string& line);
+
+	// Состояние на конец хода tick; индекс строится заново, если его нет или лог изменился
+	ReplayState seekReplay(const std::string& logPath, uint64_t tick, uint64_t interval = KeyframeIndex::kDefaultInterval);
+}
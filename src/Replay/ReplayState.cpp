@@ -0,0 +1,121 @@
+#include "ReplayState.hpp"
+
+#include <IO/System/details/RecordReadVisitor.hpp>
+#include <IO/System/details/RecordWriteVisitor.hpp>
+
+#include <stdexcept>
+#include <string>
+
+namespace sw::replay {
+
+	std::vector<ReplayUnit> ReplayState::aliveUnits() const {
+		std::vector<ReplayUnit> alive;
+		alive.reserve(_byId.size());
+		for (size_t i = 0; i < _units.size(); ++i) {
+			auto it = _byId.find(_units[i].unitId);
+			if (it != _byId.end() && it->second == i)
+				alive.push_back(_units[i]);
+		}
+		return alive;
+	}
+
+	ReplayUnit& ReplayState::unit(uint32_t unitId) {
+		auto it = _byId.find(unitId);
+		if (it == _byId.end())
+			throw std::runtime_error("Replay: event for unknown unit " + std::to_string(unitId));
+		return _units[it->second];
+	}
+
+	void ReplayState::add(ReplayUnit unit) {
+		if (_byId.contains(unit.unitId))
+			throw std::runtime_error("Replay: duplicate unit " + std::to_string(unit.unitId));
+		_byId.emplace(unit.unitId, _units.size());
+		_units.push_back(std::move(unit));
+	}
+
+	void ReplayState::apply(const io::MapCreated& event) {
+		_width = event.width;
+		_height = event.height;
+		_units.clear();
+		_byId.clear();
+	}
+
+	void ReplayState::apply(const io::UnitSpawned& event) {
+		ReplayUnit spawned;
+		spawned.unitId = event.unitId;
+		spawned.unitType = event.unitType;
+		spawned.x = event.x;
+		spawned.y = event.y;
+		add(std::move(spawned));
+	}
+
+	void ReplayState::apply(const io::UnitMoved& event) {
+		ReplayUnit& moved = unit(event.unitId);
+		moved.x = event.x;
+		moved.y = event.y;
+	}
+
+	void ReplayState::apply(const io::UnitAttacked& event) {
+		ReplayUnit& target = unit(event.targetUnitId);
+		target.hpKnown = true;
+		target.hp = event.targetHp;
+	}
+
+	void ReplayState::apply(const io::UnitDied& event) {
+		unit(event.unitId);
+		_byId.erase(event.unitId);
+	}
+
+	void ReplayState::apply(const io::MarchStarted& event) {
+		ReplayUnit& marching = unit(event.unitId);
+		marching.marching = true;
+		marching.targetX = event.targetX;
+		marching.targetY = event.targetY;
+	}
+
+	void ReplayState::apply(const io::MarchEnded& event) {
+		unit(event.unitId).marching = false;
+	}
+
+	void ReplayState::serialize(std::vector<std::byte>& buffer) const {
+		RecordWriteVisitor writer(buffer);
+		std::vector<ReplayUnit> alive = aliveUnits();
+		writer.visit("tick", _tick);
+		writer.visit("width", _width);
+		writer.visit("height", _height);
+		writer.visit("unitCount", static_cast<uint64_t>(alive.size()));
+		for (ReplayUnit& unit : alive)
+			unit.visit(writer);
+	}
+
+	ReplayState ReplayState::deserialize(const std::byte* data, size_t size) {
+		ReplayState state;
+		RecordReadVisitor reader(data, data + size);
+		uint64_t unitCount{};
+		reader.visit("tick", state._tick);
+		reader.visit("width", state._width);
+		reader.visit("height", state._height);
+		reader.visit("unitCount", unitCount);
+		for (uint64_t i = 0; i < unitCount; ++i) {
+			ReplayUnit unit;
+			unit.visit(reader);
+			state.add(std::move(unit));
+		}
+		return state;
+	}
+
+	void printReplayState(std::ostream& stream, const ReplayState& state) {
+		const std::vector<ReplayUnit> alive = state.aliveUnits();
+		stream << "STATE tick=" << state.tick() << " width=" << state.width() << " height=" << state.height() << " units=" << alive.size() << '\n';
+		for (const ReplayUnit& unit : alive) {
+			stream << "UNIT unitId=" << unit.unitId << " unitType=" << unit.unitType << " x=" << unit.x << " y=" << unit.y << " hp=";
+			if (unit.hpKnown)
+				stream << unit.hp;
+			else
+				stream << '?';
+			if (unit.marching)
+				stream << " targetX=" << unit.targetX << " targetY=" << unit.targetY;
+			stream << '\n';
+		}
+	}
+}
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <IO/Events/MapCreated.hpp>
+#include <IO/Events/MarchEnded.hpp>
+#include <IO/Events/MarchStarted.hpp>
+#include <IO/Events/UnitAttacked.hpp>
+#include <IO/Events/UnitDied.hpp>
+#include <IO/Events/UnitMoved.hpp>
+#include <IO/Events/UnitSpawned.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace sw::replay {
+
+	// Юнит, восстановленный по логу событий
+	struct ReplayUnit {
+		uint32_t unitId{};
+		std::string unitType{};
+		uint32_t x{};
+		uint32_t y{};
+		// В UNIT_SPAWNED нет hp: оно становится известно после первой атаки по юниту
+		bool hpKnown{};
+		uint32_t hp{};
+		bool marching{};
+		uint32_t targetX{};
+		uint32_t targetY{};
+
+		template <typename Visitor>
+		void visit(Visitor& visitor) {
+			visitor.visit("unitId", unitId);
+			visitor.visit("unitType", unitType);
+			visitor.visit("x", x);
+			visitor.visit("y", y);
+			visitor.visit("hpKnown", hpKnown);
+			visitor.visit("hp", hp);
+			visitor.visit("marching", marching);
+			visitor.visit("targetX", targetX);
+			visitor.visit("targetY", targetY);
+		}
+	};
+
+	// Состояние мира на конец хода tick(), собранное применением событий лога
+	class ReplayState {
+	public:
+		uint64_t tick() const {
+			return _tick;
+		}
+
+		uint32_t width() const {
+			return _width;
+		}
+
+		uint32_t height() const {
+			return _height;
+		}
+
+		// Живые юниты в порядке создания
+		std::vector<ReplayUnit> aliveUnits() const;
+
+		void setTick(uint64_t tick) {
+			_tick = tick;
+		}
+
+		void apply(const io::MapCreated& event);
+		void apply(const io::UnitSpawned& event);
+		void apply(const io::UnitMoved& event);
+		void apply(const io::UnitAttacked& event);
+		void apply(const io::UnitDied& event);
+		void apply(const io::MarchStarted& event);
+		void apply(const io::MarchEnded& event);
+
+		// Двоичный снимок для ключевого кадра
+		void serialize(std::vector<std::byte>& buffer) const;
+		// Кадр читается только в пределах size байт, обрезанный кадр — исключение
+		static ReplayState deserialize(const std::byte* data, size_t size);
+
+	private:
+		ReplayUnit& unit(uint32_t unitId);
+		void add(ReplayUnit unit);
+
+		uint64_t _tick{};
+		uint32_t _width{};
+		uint32_t _height{};
+		// Погибшие остаются в _units до сериализации, но удаляются из _byId
+		std::vector<ReplayUnit> _units;
+		std::unordered_map<uint32_t, size_t> _byId;
+	};
+
+	void printReplayState(std::ostream& stream, const ReplayState& state);
+}
@@ -0,0 +1,205 @@
+#include "ClusterPartition.hpp"
+
+#include <algorithm>
+#include <numeric>
+#include <optional>
+#include <unordered_map>
+
+namespace sw::shard {
+
+	namespace {
+		// Прямоугольник с включительными границами
+		struct Box {
+			int64_t x0{};
+			int64_t y0{};
+			int64_t x1{};
+			int64_t y1{};
+
+			void extend(const core::Coord& c) {
+				x0 = std::min<int64_t>(x0, c.x);
+				y0 = std::min<int64_t>(y0, c.y);
+				x1 = std::max<int64_t>(x1, c.x);
+				y1 = std::max<int64_t>(y1, c.y);
+			}
+
+			void extend(const Box& other) {
+				x0 = std::min(x0, other.x0);
+				y0 = std::min(y0, other.y0);
+				x1 = std::max(x1, other.x1);
+				y1 = std::max(y1, other.y1);
+			}
+
+			static Box at(const core::Coord& c) {
+				return Box{c.x, c.y, c.x, c.y};
+			}
+		};
+
+		// Наименьшее расстояние Чебышева между клетками двух прямоугольников
+		int64_t gap(const Box& a, const Box& b) {
+			return std::max({a.x0 - b.x1, b.x0 - a.x1, a.y0 - b.y1, b.y0 - a.y1, int64_t{0}});
+		}
+
+		class DisjointSets {
+		public:
+			explicit DisjointSets(size_t count)
+				: _parent(count)
+			{
+				std::iota(_parent.begin(), _parent.end(), size_t{0});
+			}
+
+			size_t find(size_t x) {
+				while (_parent[x] != x) {
+					_parent[x] = _parent[_parent[x]];
+					x = _parent[x];
+				}
+				return x;
+			}
+
+			// true, если множества были разными
+			bool unite(size_t a, size_t b) {
+				a = find(a);
+				b = find(b);
+				if (a == b)
+					return false;
+				_parent[std::max(a, b)] = std::min(a, b);
+				return true;
+			}
+
+		private:
+			std::vector<size_t> _parent;
+		};
+
+		// Объединяет пересекающиеся с запасом link прямоугольники, пока такие есть.
+		// Возвращает для каждого исходного прямоугольника номер итоговой группы
+		std::vector<size_t> mergeBoxes(std::vector<Box> boxes, int64_t link) {
+			std::vector<size_t> group(boxes.size());
+			std::iota(group.begin(), group.end(), size_t{0});
+			bool merged = true;
+			while (merged) {
+				merged = false;
+				DisjointSets sets(boxes.size());
+				// Проход по возрастанию x0: пары с зазором по x больше link дальше не проверяются
+				std::vector<size_t> order(boxes.size());
+				std::iota(order.begin(), order.end(), size_t{0});
+				std::sort(order.begin(), order.end(), [&](size_t a, size_t b) { return boxes[a].x0 < boxes[b].x0; });
+				for (size_t i = 0; i < order.size(); ++i) {
+					const Box& a = boxes[order[i]];
+					for (size_t j = i + 1; j < order.size() && boxes[order[j]].x0 <= a.x1 + link; ++j) {
+						if (gap(a, boxes[order[j]]) <= link && sets.unite(order[i], order[j]))
+							merged = true;
+					}
+				}
+				if (!merged)
+					break;
+
+				std::vector<size_t> renumbered(boxes.size(), boxes.size());
+				std::vector<Box> next;
+				for (size_t i = 0; i < boxes.size(); ++i) {
+					const size_t root = sets.find(i);
+					if (renumbered[root] == boxes.size()) {
+						renumbered[root] = next.size();
+						next.push_back(boxes[i]);
+					} else {
+						next[renumbered[root]].extend(boxes[i]);
+					}
+					renumbered[i] = renumbered[root];
+				}
+				for (size_t& g : group)
+					g = renumbered[g];
+				boxes = std::move(next);
+			}
+			return group;
+		}
+	}
+
+	std::vector<std::vector<size_t>> independentClusters(const core::World& world, uint64_t ticks) {
+		const std::optional<int32_t> maxStep = world.maxStepPerTurn();
+		if (!maxStep || world.nonBlockingUnitsCount() > 0)
+			return {};
+
+		const auto& units = world.unitsInCreationOrder();
+		// Соседние клетки читает и движение (заблокирован ли шаг), поэтому дальность не меньше шага
+		int64_t reach = std::max(1, *maxStep);
+		for (const auto& unit : units) {
+			if (unit && unit->interactionReach())
+				reach = std::max<int64_t>(reach, *unit->interactionReach());
+		}
+		const int64_t link = reach + 2 * int64_t{*maxStep} * static_cast<int64_t>(ticks);
+
+		// Корзины со стороной link: юниты дальше соседних корзин заведомо не связаны.
+		// Корзины связываются по зазору между прямоугольниками их юнитов — с запасом, но без перебора пар юнитов
+		struct Bucket {
+			int64_t bx{};
+			int64_t by{};
+			Box box;
+		};
+		auto keyOf = [](int64_t bx, int64_t by) {
+			return (static_cast<uint64_t>(by) << 32) | static_cast<uint64_t>(bx);
+		};
+		std::vector<Bucket> buckets;
+		std::unordered_map<uint64_t, size_t> bucketByKey;
+		std::vector<size_t> unitBucket(units.size(), 0);
+		for (size_t slot = 0; slot < units.size(); ++slot) {
+			const core::Unit* unit = units[slot].get();
+			if (!unit)
+				continue;
+			const core::Coord c = unit->position();
+			const int64_t bx = c.x / link;
+			const int64_t by = c.y / link;
+			auto [it, inserted] = bucketByKey.try_emplace(keyOf(bx, by), buckets.size());
+			if (inserted)
+				buckets.push_back(Bucket{bx, by, Box::at(c)});
+			else
+				buckets[it->second].box.extend(c);
+			unitBucket[slot] = it->second;
+		}
+		if (buckets.empty())
+			return {};
+
+		DisjointSets bucketSets(buckets.size());
+		for (size_t i = 0; i < buckets.size(); ++i) {
+			const Bucket& bucket = buckets[i];
+			for (const auto& [dx, dy] : {std::pair{1, -1}, std::pair{1, 0}, std::pair{1, 1}, std::pair{0, 1}}) {
+				if (bucket.bx + dx < 0 || bucket.by + dy < 0)
+					continue;
+				auto it = bucketByKey.find(keyOf(bucket.bx + dx, bucket.by + dy));
+				if (it != bucketByKey.end() && gap(bucket.box, buckets[it->second].box) <= link)
+					bucketSets.unite(i, it->second);
+			}
+		}
+
+		// Прямоугольники групп соседства вместе с целями марша, затем слияние пересекающихся
+		std::vector<size_t> proximityGroup(buckets.size(), buckets.size());
+		std::vector<Box> boxes;
+		for (size_t i = 0; i < buckets.size(); ++i) {
+			const size_t root = bucketSets.find(i);
+			if (proximityGroup[root] == buckets.size()) {
+				proximityGroup[root] = boxes.size();
+				boxes.push_back(buckets[i].box);
+			} else {
+				boxes[proximityGroup[root]].extend(buckets[i].box);
+			}
+			proximityGroup[i] = proximityGroup[root];
+		}
+		for (size_t slot = 0; slot < units.size(); ++slot) {
+			const core::Unit* unit = units[slot].get();
+			if (unit && unit->marchTarget())
+				boxes[proximityGroup[unitBucket[slot]]].extend(*unit->marchTarget());
+		}
+		const std::vector<size_t> group = mergeBoxes(std::move(boxes), link);
+
+		std::vector<std::vector<size_t>> clusters;
+		std::vector<size_t> clusterOfGroup(group.size(), group.size());
+		for (size_t slot = 0; slot < units.size(); ++slot) {
+			if (!units[slot])
+				continue;
+			size_t& cluster = clusterOfGroup[group[proximityGroup[unitBucket[slot]]]];
+			if (cluster == group.size()) {
+				cluster = clusters.size();
+				clusters.emplace_back();
+			}
+			clusters[cluster].push_back(slot);
+		}
+		return clusters;
+	}
+}
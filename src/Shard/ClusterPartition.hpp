@@ -0,0 +1,19 @@
+#pragma once
+
+#include <Core/World.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace sw::shard {
+
+	// Разбиение живых юнитов мира на группы, которые заведомо не влияют друг на друга ближайшие ticks ходов.
+	// За ход юнит смещается не дальше World::maxStepPerTurn и действует на расстоянии не больше
+	// interactionReach, поэтому юниты разных групп дальше reach + 2 * maxStep * ticks друг от друга.
+	// Прямоугольник группы включает и цели марша, поэтому группы, идущие навстречу друг другу, объединяются заранее.
+	// Поиск пути может уйти и дальше прямоугольника: чужие группы он видит по снимку на начало хода (core::PathingView).
+	// Группы — слоты юнитов в порядке создания, упорядочены по первому слоту.
+	// Пустой результат — мир не разбивается (есть юниты, не занимающие клетки, или шаг за ход неизвестен)
+	std::vector<std::vector<size_t>> independentClusters(const core::World& world, uint64_t ticks);
+}
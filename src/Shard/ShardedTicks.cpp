@@ -0,0 +1,309 @@
+#include "ShardedTicks.hpp"
+
+#include "ClusterPartition.hpp"
+
+#include <Core/GridMap.hpp>
+#include <Core/TurnLoop.hpp>
+
+#include <algorithm>
+#include <numeric>
+#include <utility>
+
+namespace sw::shard {
+
+	struct ShardedTicks::Shard {
+		// События хода одного юнита: записи [begin, end) буфера лога шарда
+		struct Segment {
+			size_t mainSlot{};
+			size_t begin{};
+			size_t end{};
+			uint64_t events{};
+		};
+
+		// Перемещение юнита за ход; slot — слот мира шарда
+		struct Move {
+			size_t slot{};
+			core::Coord from{};
+			core::Coord to{};
+		};
+
+		std::unique_ptr<core::World> world;
+		EventLog log;
+		core::Perception perception;
+		core::RandomSource random;
+		// Слот основного мира для каждого слота мира шарда
+		std::vector<size_t> mainSlots;
+		// Юниты, взятые из основного мира, до переноса в мир шарда
+		std::vector<core::PoolPtr<core::Unit>> arriving;
+		// Группа и позиция в снимке по слоту мира шарда
+		std::vector<uint32_t> groups;
+		std::vector<core::Coord> positions;
+		// Снимок для поиска пути и число уже примененных к нему изменений журнала
+		std::unique_ptr<core::GridMap> snapshot;
+		size_t snapshotChanges{};
+
+		// Итог последнего хода
+		std::vector<Segment> segments;
+		std::vector<size_t> deadSlots;
+		std::vector<Move> moves;
+		size_t aliveUnits{};
+		bool anyActed = false;
+	};
+
+	ShardedTicks::ShardedTicks(size_t threads, uint64_t randomKey)
+		: _threads(std::max<size_t>(threads, 1))
+		, _randomKey(randomKey)
+	{
+		for (size_t i = 1; i < _threads; ++i)
+			_workers.emplace_back([this] { work(); });
+	}
+
+	ShardedTicks::~ShardedTicks() {
+		{
+			std::lock_guard lock(_mutex);
+			_stopping = true;
+		}
+		_started.notify_all();
+		for (std::thread& worker : _workers)
+			worker.join();
+	}
+
+	void ShardedTicks::prepare(core::World& world, const EventLog& log, uint64_t tick) {
+		if (!_clusters.empty() && tick > _epochEnd) {
+			dissolve(world);
+			_clusters.clear();
+		}
+		if (_clusters.empty() && tick >= _nextAttempt) {
+			_clusters = independentClusters(world, kEpochTicks);
+			if (_clusters.size() < 2) {
+				_clusters.clear();
+				_nextAttempt = tick + kEpochTicks;
+			} else {
+				_epochEnd = tick + kEpochTicks - 1;
+			}
+		}
+		if (!_clusters.empty() && !active())
+			distribute(world, log);
+	}
+
+	void ShardedTicks::distribute(core::World& world, const EventLog& log) {
+		// Начало журнала снимка и группы по слотам основного мира; погибшие с начала разбиения юниты пропускаются
+		const core::GridMap& map = world.map();
+		const auto& units = world.unitsInCreationOrder();
+		_snapshotChanges.clear();
+		_snapshotGroups.assign(units.size(), 0);
+		std::vector<std::vector<size_t>> clusters;
+		for (const std::vector<size_t>& cluster : _clusters) {
+			std::vector<size_t> alive;
+			for (size_t slot : cluster) {
+				if (!units[slot])
+					continue;
+				alive.push_back(slot);
+				_snapshotGroups[slot] = static_cast<uint32_t>(clusters.size());
+				_snapshotChanges.push_back(CellChange{units[slot]->position(), static_cast<int32_t>(slot)});
+			}
+			if (!alive.empty())
+				clusters.push_back(std::move(alive));
+		}
+		if (clusters.empty())
+			return;
+
+		// Группы раскладываются от больших к меньшим в наименее загруженный шард
+		const size_t shardCount = std::min(_threads, clusters.size());
+		std::vector<size_t> order(clusters.size());
+		std::iota(order.begin(), order.end(), size_t{0});
+		std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) { return clusters[a].size() > clusters[b].size(); });
+		std::vector<size_t> load(shardCount, 0);
+		for (size_t i = 0; i < shardCount; ++i)
+			_shards.push_back(std::make_unique<Shard>());
+		for (size_t cluster : order) {
+			const size_t target = static_cast<size_t>(std::min_element(load.begin(), load.end()) - load.begin());
+			load[target] += clusters[cluster].size();
+			std::vector<size_t>& slots = _shards[target]->mainSlots;
+			slots.insert(slots.end(), clusters[cluster].begin(), clusters[cluster].end());
+		}
+
+		for (auto& shard : _shards) {
+			std::sort(shard->mainSlots.begin(), shard->mainSlots.end());
+			shard->arriving.reserve(shard->mainSlots.size());
+			for (size_t slot : shard->mainSlots) {
+				shard->groups.push_back(_snapshotGroups[slot]);
+				shard->positions.push_back(units[slot]->position());
+				shard->arriving.push_back(world.lendUnit(slot));
+			}
+			shard->random = core::RandomSource(_randomKey);
+			shard->log.enableRecording();
+			shard->log.setFilter(log.filter());
+		}
+
+		forEachShard([&](Shard& shard) {
+			shard.world = std::make_unique<core::World>(core::GridMap{map.width(), map.height(), map.layout()});
+			for (auto& unit : shard.arriving)
+				shard.world->adoptUnit(std::move(unit));
+			shard.arriving.clear();
+			shard.world->setPathingGroups(shard.groups, [this, &shard]() -> const core::GridMap& { return snapshotFor(shard); }, _snapshotGroups);
+			shard.aliveUnits = shard.world->aliveUnitsCount();
+		});
+	}
+
+	TickOutcome ShardedTicks::advance(uint64_t tick, EventLog& log) {
+		forEachShard([&](Shard& shard) {
+			shard.log.clearRecorded();
+			shard.segments.clear();
+			size_t mark = 0;
+			uint64_t eventsMark = shard.log.loggedEvents();
+			shard.anyActed = core::takeTurns(*shard.world, shard.log, tick, shard.perception, shard.random, [&](const core::Unit& unit) {
+				const size_t size = shard.log.recorded().size();
+				if (size == mark)
+					return;
+				const uint64_t events = shard.log.loggedEvents();
+				shard.segments.push_back(Shard::Segment{shard.mainSlots[shard.world->handleOf(unit).slot], mark, size, events - eventsMark});
+				mark = size;
+				eventsMark = events;
+			});
+			shard.deadSlots = shard.world->deadUnitSlots();
+			shard.aliveUnits = shard.world->aliveUnitsCount();
+
+			shard.moves.clear();
+			const auto& units = shard.world->unitsInCreationOrder();
+			for (size_t slot = 0; slot < units.size(); ++slot) {
+				if (units[slot] && units[slot]->position() != shard.positions[slot]) {
+					shard.moves.push_back(Shard::Move{slot, shard.positions[slot], units[slot]->position()});
+					shard.positions[slot] = units[slot]->position();
+				}
+			}
+		});
+		recordSnapshotChanges();
+
+		// Слияние ходов шардов по слоту основного мира: каждый шард уже идет в порядке создания
+		TickOutcome outcome;
+		std::vector<size_t> next(_shards.size(), 0);
+		while (true) {
+			size_t best = _shards.size();
+			for (size_t i = 0; i < _shards.size(); ++i) {
+				if (next[i] == _shards[i]->segments.size())
+					continue;
+				if (best == _shards.size() || _shards[i]->segments[next[i]].mainSlot < _shards[best]->segments[next[best]].mainSlot)
+					best = i;
+			}
+			if (best == _shards.size())
+				break;
+			const Shard& shard = *_shards[best];
+			const Shard::Segment& segment = shard.segments[next[best]++];
+			log.appendRecorded(tick, shard.log.recorded().data() + segment.begin, segment.end - segment.begin, segment.events);
+		}
+
+		// Мертвые удаляются на этом потоке: память юнитов возвращается в пул основного мира
+		std::vector<std::pair<size_t, uint32_t>> died;
+		for (auto& shard : _shards) {
+			outcome.anyActed = outcome.anyActed || shard->anyActed;
+			const std::vector<uint32_t> ids = shard->world->removeUnits(shard->deadSlots);
+			for (size_t i = 0; i < ids.size(); ++i)
+				died.emplace_back(shard->mainSlots[shard->deadSlots[i]], ids[i]);
+		}
+		std::sort(died.begin(), died.end());
+		for (const auto& [slot, id] : died)
+			outcome.diedUnits.push_back(id);
+		return outcome;
+	}
+
+	// Клетки сначала освобождаются, затем занимаются: юнит мог встать на клетку, которую в этом ходу покинул другой
+	void ShardedTicks::recordSnapshotChanges() {
+		for (const auto& shard : _shards) {
+			for (const Shard::Move& move : shard->moves)
+				_snapshotChanges.push_back(CellChange{move.from, core::GridMap::kEmptyCell});
+		}
+		for (const auto& shard : _shards) {
+			for (const Shard::Move& move : shard->moves)
+				_snapshotChanges.push_back(CellChange{move.to, static_cast<int32_t>(shard->mainSlots[move.slot])});
+			for (size_t slot : shard->deadSlots)
+				_snapshotChanges.push_back(CellChange{shard->positions[slot], core::GridMap::kEmptyCell});
+		}
+	}
+
+	// Вызывается из хода шарда; журнал в это время только читается
+	const core::GridMap& ShardedTicks::snapshotFor(Shard& shard) {
+		if (!shard.snapshot) {
+			const core::GridMap& map = shard.world->map();
+			shard.snapshot = std::make_unique<core::GridMap>(map.width(), map.height(), map.layout());
+		}
+		for (; shard.snapshotChanges < _snapshotChanges.size(); ++shard.snapshotChanges) {
+			const CellChange& change = _snapshotChanges[shard.snapshotChanges];
+			if (change.occupant == core::GridMap::kEmptyCell)
+				shard.snapshot->clear(change.cell);
+			else
+				shard.snapshot->setOccupied(change.cell, change.occupant);
+		}
+		return *shard.snapshot;
+	}
+
+	void ShardedTicks::dissolve(core::World& world) {
+		for (auto& shard : _shards) {
+			for (size_t slot = 0; slot < shard->mainSlots.size(); ++slot)
+				world.returnUnit(shard->mainSlots[slot], shard->world->lendUnit(slot), shard->world->unitStats()[slot]);
+		}
+		_shards.clear();
+		_snapshotChanges.clear();
+	}
+
+	size_t ShardedTicks::aliveUnits() const {
+		size_t total = 0;
+		for (const auto& shard : _shards)
+			total += shard->aliveUnits;
+		return total;
+	}
+
+	uint64_t ShardedTicks::stateHash() const {
+		uint64_t hash = 0;
+		for (const auto& shard : _shards)
+			hash ^= shard->world->stateHash();
+		return hash;
+	}
+
+	void ShardedTicks::forEachShard(const std::function<void(Shard&)>& job) {
+		{
+			std::lock_guard lock(_mutex);
+			_job = &job;
+			_nextShard.store(0);
+			_workersDone = 0;
+			++_generation;
+		}
+		_started.notify_all();
+		drain(job);
+
+		std::unique_lock lock(_mutex);
+		_finished.wait(lock, [&] { return _workersDone == _workers.size(); });
+		_job = nullptr;
+		if (_error)
+			std::rethrow_exception(std::exchange(_error, nullptr));
+	}
+
+	void ShardedTicks::work() {
+		uint64_t seen = 0;
+		std::unique_lock lock(_mutex);
+		while (true) {
+			_started.wait(lock, [&] { return _stopping || _generation != seen; });
+			if (_stopping)
+				return;
+			seen = _generation;
+			const std::function<void(Shard&)>& job = *_job;
+			lock.unlock();
+			drain(job);
+			lock.lock();
+			if (++_workersDone == _workers.size())
+				_finished.notify_all();
+		}
+	}
+
+	void ShardedTicks::drain(const std::function<void(Shard&)>& job) {
+		for (size_t i = _nextShard.fetch_add(1); i < _shards.size(); i = _nextShard.fetch_add(1)) {
+			try {
+				job(*_shards[i]);
+			} catch (...) {
+				std::lock_guard lock(_mutex);
+				if (!_error)
+					_error = std::current_exception();
+			}
+		}
+	}
+}
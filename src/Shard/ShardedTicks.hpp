@@ -0,0 +1,113 @@
+#pragma once
+
+#include <Core/GridMap.hpp>
+#include <Core/Perception.hpp>
+#include <Core/RandomSource.hpp>
+#include <Core/World.hpp>
+#include <IO/System/EventLog.hpp>
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace sw::shard {
+
+	// Итог хода по всем шардам
+	struct TickOutcome {
+		bool anyActed = false;
+		// Погибшие в этом ходу в порядке создания (удалены из миров шардов, событие UnitDied еще не записано)
+		std::vector<uint32_t> diedUnits;
+	};
+
+	// Один бой, разбитый на независимые группы юнитов (independentClusters), на нескольких потоках.
+	// Группы раскладываются по шардам — отдельным мирам, по одному на поток; в шарде юниты ходят
+	// в порядке создания, как в основном мире. Ход выполняется всеми шардами одновременно, затем события
+	// ходов сливаются в порядке создания юнитов.
+	// Разбиение действует kEpochTicks ходов, после чего мир разбивается заново: сблизившиеся группы объединяются.
+	// Результат не зависит от числа потоков: случайный выбор целей берется из RandomSource с ключом,
+	// а поиск пути видит свою группу по карте шарда, а остальные — по снимку на начало хода (core::PathingView).
+	// С обычным ходом в одном мире результат не совпадает
+	class ShardedTicks {
+	public:
+		static constexpr uint64_t kEpochTicks = 16;
+
+		ShardedTicks(size_t threads, uint64_t randomKey);
+		~ShardedTicks();
+
+		ShardedTicks(const ShardedTicks&) = delete;
+		ShardedTicks& operator=(const ShardedTicks&) = delete;
+
+		// Перед ходом tick: по окончании разбиения мир разбивается заново, если пора, и юниты раскладываются
+		// по шардам. Если независимых групп меньше двух, ход выполняется в основном мире, а попытка повторяется
+		// через kEpochTicks ходов
+		void prepare(core::World& world, const EventLog& log, uint64_t tick);
+
+		// Юниты сейчас в шардах: основной мир пуст, ходы выполняет advance
+		bool active() const {
+			return !_shards.empty();
+		}
+
+		// Ход всех шардов; события ходов записываются в log
+		TickOutcome advance(uint64_t tick, EventLog& log);
+
+		// Возвращает всех юнитов в основной мир. Разбиение сохраняется: следующий prepare разложит юнитов
+		// по тем же группам, поэтому чтение мира между ходами не меняет хода боя
+		void dissolve(core::World& world);
+
+		// Живые юниты и хеш состояния всех шардов после последнего advance
+		size_t aliveUnits() const;
+		uint64_t stateHash() const;
+
+	private:
+		struct Shard;
+
+		// Изменение клетки снимка: occupant — слот основного мира или core::GridMap::kEmptyCell
+		struct CellChange {
+			core::Coord cell{};
+			int32_t occupant{};
+		};
+
+		// Раскладывает живых юнитов групп _clusters по шардам
+		void distribute(core::World& world, const EventLog& log);
+		// Дописывает перемещения и смерти хода в журнал снимка
+		void recordSnapshotChanges();
+		// Снимок шарда, догнанный по журналу до начала текущего хода
+		const core::GridMap& snapshotFor(Shard& shard);
+		// Вызывает job для каждого шарда на потоках пула и на вызывающем и ждет всех
+		void forEachShard(const std::function<void(Shard&)>& job);
+		void work();
+		void drain(const std::function<void(Shard&)>& job);
+
+		size_t _threads{};
+		uint64_t _randomKey{};
+		std::vector<std::unique_ptr<Shard>> _shards;
+		// Группы текущего разбиения (слоты основного мира); пусто — мир не разбит
+		std::vector<std::vector<size_t>> _clusters;
+		// Занятость всего боя на начало хода — журнал изменений клеток с начала разбиения.
+		// Сам снимок шард собирает из журнала, только когда его юнит ищет путь; группа — по слоту основного мира
+		std::vector<CellChange> _snapshotChanges;
+		std::vector<uint32_t> _snapshotGroups;
+		// Последний ход текущего разбиения и ход следующей попытки разбить мир
+		uint64_t _epochEnd{};
+		uint64_t _nextAttempt{};
+
+		std::mutex _mutex;
+		std::condition_variable _started;
+		std::condition_variable _finished;
+		const std::function<void(Shard&)>* _job = nullptr;
+		// Номер текущего задания; каждый поток пула участвует в каждом задании и отчитывается о нем
+		uint64_t _generation{};
+		size_t _workersDone{};
+		std::atomic<size_t> _nextShard{};
+		std::exception_ptr _error;
+		bool _stopping = false;
+		std::vector<std::thread> _workers;
+	};
+}
@@ -1,123 +1,492 @@
 #include <SimulationRunner.hpp>
 
 #include <Core/GridMap.hpp>
+#include <Core/TurnLoop.hpp>
 #include <Features/UnitFactory.hpp>
 #include <IO/Events/UnitDied.hpp>
 #include <IO/Commands/CreateMap.hpp>
 #include <IO/Commands/March.hpp>
 #include <IO/Commands/SpawnHunter.hpp>
+#include <IO/Commands/SpawnHunterFormation.hpp>
 #include <IO/Commands/SpawnSwordsman.hpp>
+#include <IO/Commands/SpawnSwordsmanFormation.hpp>
 #include <IO/Events/MapCreated.hpp>
+#include <IO/Events/MarchEnded.hpp>
 #include <IO/Events/MarchStarted.hpp>
+#include <IO/Events/UnitMoved.hpp>
 #include <IO/Events/UnitSpawned.hpp>
+#include <IO/System/CompiledScenario.hpp>
 
+#include <algorithm>
+#include <cstdlib>
+#include <limits>
+#include <ostream>
 #include <stdexcept>
 #include <string>
 
 namespace sw {
 
-	constexpr uint64_t kMaxSimulationTicks = 10000;
-
-	SimulationRunner::SimulationRunner() {
-		setupParser();
+	namespace {
+		using ScenarioCommands = io::CommandList<
+			io::CreateMap,
+			io::SpawnSwordsman,
+			io::SpawnHunter,
+			io::March,
+			io::SpawnSwordsmanFormation,
+			io::SpawnHunterFormation>;
 	}
 
 	void SimulationRunner::run(std::istream& stream) {
-		_parser.parse(stream);
+		load(stream);
+		simulate();
+	}
 
+	void SimulationRunner::load(std::istream& stream) {
+		_parser.parse(stream, ScenarioCommands{}, [this](auto command) {
+			handle(std::move(command));
+		});
+	}
+
+	void SimulationRunner::load(std::string_view text) {
+		_parser.parse(text, ScenarioCommands{}, [this](auto command) {
+			handle(std::move(command));
+		});
+	}
+
+	void SimulationRunner::loadCompiled(const std::byte* data, size_t size) {
+		io::readCompiledScenario(data, size, ScenarioCommands{}, [this](auto command) {
+			apply(std::move(command));
+		});
+	}
+
+	void SimulationRunner::compile(std::istream& stream, std::ostream& out) {
+		// Команды применяются к миру, чтобы проверки зависели от состояния так же, как при обычном запуске
+		io::CompiledScenarioWriter<ScenarioCommands> writer;
+		_parser.parse(stream, ScenarioCommands{}, [&](auto command) {
+			writer.add(command);
+			handle(std::move(command));
+		});
 		if (!_world)
 			throw std::runtime_error("Scenario did not create a map");
+		writer.write(out);
+	}
 
-		core::WorldView worldView(*_world);
+	void SimulationRunner::simulate() {
+		while (!_finished)
+			step(std::numeric_limits<uint64_t>::max());
+	}
 
-		// На всякий случай добавим ограничение на количество ходов
-		// Основной цикл симуляции
-		while (_world->aliveUnitsCount() > 1 && _tick < kMaxSimulationTicks) {
-			++_tick;
-			bool anyActed = false;
-			for (const auto& uptr : _world->unitsInCreationOrder()) {
-				if (!uptr)
-					continue;
+	uint64_t SimulationRunner::step(uint64_t ticks) {
+		start();
+		uint64_t done = 0;
+		while (done < ticks && !_finished) {
+			const uint64_t skipped = skipMarchTicks(ticks - done);
+			if (skipped == 0) {
+				advanceTick();
+				++done;
+			}
+			done += skipped;
+		}
+		if (_finished)
+			gather();
+		return done;
+	}
 
-				core::TurnContext ctx{worldView, _eventLog, _tick};
-				if (uptr->takeTurn(ctx))
-					anyActed = true;
+	uint64_t SimulationRunner::runUntil(std::chrono::steady_clock::time_point deadline) {
+		start();
+		uint64_t done = 0;
+		while (!_finished && std::chrono::steady_clock::now() < deadline) {
+			const uint64_t skipped = skipMarchTicks(std::numeric_limits<uint64_t>::max());
+			if (skipped == 0) {
+				advanceTick();
+				++done;
 			}
+			done += skipped;
+		}
+		if (_finished)
+			gather();
+		return done;
+	}
+
+	void SimulationRunner::setTickCap(uint64_t tickCap) {
+		_tickCap = tickCap;
+		// Бой, остановленный прежним пределом, можно продолжить
+		if (_finished && _terminationReason == TerminationReason::TickCap && _tick < _tickCap)
+			_finished = false;
+		if (_started && !_finished)
+			checkFinished();
+	}
+
+	const core::World& SimulationRunner::world() const {
+		if (!_world)
+			throw std::runtime_error("Scenario did not create a map");
+		requireGathered();
+		return *_world;
+	}
+
+	void SimulationRunner::gather() {
+		if (_shards)
+			_shards->dissolve(*_world);
+	}
+
+	void SimulationRunner::requireGathered() const {
+		if (_shards && _shards->active())
+			throw std::runtime_error("Units are in shards: call gather before reading the world");
+	}
+
+	void SimulationRunner::start() {
+		if (_started)
+			return;
+		if (!_world)
+			throw std::runtime_error("Scenario did not create a map");
+		_started = true;
+
+		if (_randomKey)
+			_random = core::RandomSource(*_randomKey);
+		// Без заданного ключа он берется из std::rand, как и сами выборы без шардирования
+		if (_shardThreads > 0 && !_renderer) {
+			const uint64_t key = _randomKey ? *_randomKey : (static_cast<uint64_t>(std::rand()) << 32) ^ static_cast<uint64_t>(std::rand());
+			_random = core::RandomSource(key);
+			_shards = std::make_unique<shard::ShardedTicks>(_shardThreads, key);
+		}
+
+		// Хеши уже встречавшихся состояний мира на границах ходов.
+		// Повтор состояния означает зацикливание (юниты ходят туда-обратно или бьют с нулевым уроном),
+		// дальше симуляция не продвинется — останавливаемся, не дожидаясь предела ходов
+		_seenStates.seen(_world->stateHash());
+
+		if (_renderer) {
+			_world->setDirtyTracking(true);
+			_renderer->begin(_tick, *_world);
+		}
+		checkFinished();
+	}
+
+	// Остановка, если живых не больше одного или достигнут предел ходов
+	void SimulationRunner::checkFinished() {
+		const size_t aliveUnits = aliveUnitsCount();
+		publishProgress(aliveUnits);
+		if (aliveUnits <= 1 || _tick >= _tickCap) {
+			_terminationReason = aliveUnits > 1 ? TerminationReason::TickCap : TerminationReason::LastUnitStanding;
+			_finished = true;
+		}
+	}
+
+	void SimulationRunner::advanceTick() {
+		++_tick;
+		if (_shards)
+			_shards->prepare(*_world, _eventLog, _tick);
+
+		bool anyActed = false;
+		if (_shards && _shards->active()) {
+			// Мертвые уже удалены из миров шардов в конце хода
+			shard::TickOutcome outcome = _shards->advance(_tick, _eventLog);
+			anyActed = outcome.anyActed;
+			for (uint32_t id : outcome.diedUnits)
+				_eventLog.log(_tick, io::UnitDied{id});
+		} else {
+			anyActed = core::takeTurns(*_world, _eventLog, _tick, _perception, _random, [](const core::Unit&) {});
 
 			// Удаляем мертвые юниты и логируем их смерть
 			// Удаляем только в конце хода. Юниты с 0 хп смогут действовать в этом ходу (по условию)
 			for (uint32_t id : _world->removeDeadUnits())
 				_eventLog.log(_tick, io::UnitDied{id});
+		}
+
+		if (_renderer)
+			_renderer->renderTick(_tick, *_world, _world->takeDirtyCells());
 
-			// Остановка, если никто не действовал (нет юнитов, способных действовать)
-			if (!anyActed)
-				break;
+		// Остановка, если никто не действовал (нет юнитов, способных действовать)
+		if (!anyActed) {
+			_terminationReason = TerminationReason::NoActions;
+			_finished = true;
+			publishProgress(aliveUnitsCount());
+			return;
 		}
+
+		// Остановка, если мир вернулся в уже встречавшееся состояние
+		if (_seenStates.seen(stateHash())) {
+			_terminationReason = TerminationReason::RepeatedState;
+			_finished = true;
+			publishProgress(aliveUnitsCount());
+			return;
+		}
+
+		checkFinished();
 	}
 
-	void SimulationRunner::setupParser() {
+	// Те же проверки конца боя, что у advanceTick, по каждому пропущенному ходу: никто не погибает,
+	// все юниты плана двигаются, поэтому остаются повтор состояния и предел ходов
+	uint64_t SimulationRunner::skipMarchTicks(uint64_t maxTicks) {
+		if (_shards || _renderer || _tick < _nextMarchSkip)
+			return 0;
+		const uint64_t turns = _world->planMarchSkip(std::min(maxTicks, _tickCap - _tick), _marchSkip);
+		if (turns == 0) {
+			// Пока юниты сражаются, план не складывается: пробуем все реже
+			_marchSkipDelay = std::min(_marchSkipDelay * 2, core::World::kMaxQuietTurns);
+			_nextMarchSkip = _tick + _marchSkipDelay;
+			return 0;
+		}
+		_marchSkipDelay = 1;
 
-		// Создание карты
-		_parser.add<io::CreateMap>([this](io::CreateMap command) {
-			_world = std::make_unique<core::World>(core::GridMap{command.width, command.height});
-			_eventLog.log(_tick, io::MapCreated{command.width, command.height});
-		});
+		uint64_t done = 0;
+		while (done < turns && !_finished) {
+			if (_seenStates.seen(_marchSkip.stateHashes[done++])) {
+				_terminationReason = TerminationReason::RepeatedState;
+				_finished = true;
+			} else if (_tick + done >= _tickCap) {
+				_terminationReason = TerminationReason::TickCap;
+				_finished = true;
+			}
+		}
+		logMarchSkip(done);
+		_world->applyMarchSkip(_marchSkip, done);
+		_tick += done;
+		publishProgress(aliveUnitsCount());
+		return done;
+	}
 
-		// Создание мечника
-		_parser.add<io::SpawnSwordsman>([this](io::SpawnSwordsman command) {
-			if (!_world) throw std::runtime_error("Map is not created yet");
-			const int32_t hp = static_cast<int32_t>(command.hp);
-			const int32_t strength = static_cast<int32_t>(command.strength);
-			if (hp < 0) throw std::runtime_error(std::string(io::SpawnSwordsman::Name) + ": hp cannot be negative");
-			if (strength < 0) throw std::runtime_error(std::string(io::SpawnSwordsman::Name) + ": strength cannot be negative");
-			auto unit = features::createSwordsman(
-				command.unitId,
-				core::Coord{static_cast<int32_t>(command.x), static_cast<int32_t>(command.y)},
-				hp,
-				strength);
-			_world->spawn(std::move(unit));
-			_eventLog.log(_tick, io::UnitSpawned{command.unitId, "Swordsman", command.x, command.y});
-		});
+	// События пропущенных ходов в том же порядке, что у MoveBehavior: по ходам, в ходе — по порядку создания
+	void SimulationRunner::logMarchSkip(uint64_t turns) {
+		for (uint64_t turn = 0; turn < turns; ++turn) {
+			const uint64_t tick = _tick + turn + 1;
+			const bool logMoves = _eventLog.enabled<io::UnitMoved>(tick);
+			const bool logEnds = _eventLog.enabled<io::MarchEnded>(tick);
+			if (!logMoves && !logEnds)
+				continue;
+			for (const core::MarchSkip::Marcher& marcher : _marchSkip.marchers) {
+				for (size_t step = marcher.stepsIn(turn); step < marcher.stepsIn(turn + 1); ++step) {
+					const core::Coord to = _marchSkip.cells[marcher.firstCell + step];
+					const uint32_t x = static_cast<uint32_t>(to.x);
+					const uint32_t y = static_cast<uint32_t>(to.y);
+					if (logMoves)
+						_eventLog.log(tick, io::UnitMoved{marcher.unitId, x, y});
+					if (logEnds && to == marcher.target)
+						_eventLog.log(tick, io::MarchEnded{marcher.unitId, x, y});
+				}
+			}
+		}
+	}
+
+	size_t SimulationRunner::aliveUnitsCount() const {
+		if (_shards && _shards->active())
+			return _shards->aliveUnits();
+		return _world->aliveUnitsCount();
+	}
+
+	// Хеш — XOR ключей юнитов, поэтому хеши шардов складываются в хеш всего мира
+	uint64_t SimulationRunner::stateHash() const {
+		if (_shards && _shards->active())
+			return _world->stateHash() ^ _shards->stateHash();
+		return _world->stateHash();
+	}
+
+	void SimulationRunner::publishProgress(size_t aliveUnits) {
+		_progress.tick.store(_tick, std::memory_order_relaxed);
+		_progress.aliveUnits.store(aliveUnits, std::memory_order_relaxed);
+		_progress.events.store(_eventLog.loggedEvents(), std::memory_order_relaxed);
+	}
+
+	BattleSummary SimulationRunner::summary() const {
+		BattleSummary result;
+		result.ticks = _tick;
+		result.reason = _terminationReason;
+		if (!_world)
+			return result;
+		requireGathered();
+		for (const auto& unit : _world->unitsInCreationOrder()) {
+			if (unit && unit->hp() > 0)
+				result.survivors.push_back(BattleSummary::Survivor{unit->id(), unit->hp()});
+		}
+		result.units = _world->unitStats();
+		return result;
+	}
+
+	const char* terminationReasonName(TerminationReason reason) {
+		switch (reason) {
+		case TerminationReason::LastUnitStanding:
+			return "LAST_UNIT_STANDING";
+		case TerminationReason::NoActions:
+			return "NO_ACTIONS";
+		case TerminationReason::RepeatedState:
+			return "REPEATED_STATE";
+		case TerminationReason::TickCap:
+			return "TICK_CAP";
+		}
+		return "UNKNOWN";
+	}
+
+	// Формат как у событий: строка заголовка, затем по строке на выжившего и на каждого юнита
+	void printSummary(std::ostream& stream, const BattleSummary& summary) {
+		stream << "SUMMARY ticks=" << summary.ticks
+			   << " reason=" << terminationReasonName(summary.reason)
+			   << " units=" << summary.units.size()
+			   << " survivors=" << summary.survivors.size() << '\n';
+		for (const BattleSummary::Survivor& survivor : summary.survivors)
+			stream << "SURVIVOR unitId=" << survivor.unitId << " hp=" << survivor.hp << '\n';
+		for (const core::UnitStats& stats : summary.units)
+			stream << "UNIT_STATS unitId=" << stats.unitId << " damageDealt=" << stats.damageDealt << " damageTaken=" << stats.damageTaken << '\n';
+	}
+
+	// Создание карты
+	void SimulationRunner::handle(io::CreateMap command) {
+		apply(command);
+	}
+
+	void SimulationRunner::apply(io::CreateMap command) {
+		_world = std::make_unique<core::World>(core::GridMap{command.width, command.height, _cellLayout});
+		_eventLog.log(_tick, io::MapCreated{command.width, command.height});
+	}
+
+	// Создание мечника
+	void SimulationRunner::handle(io::SpawnSwordsman command) {
+		if (!_world) throw std::runtime_error("Map is not created yet");
+		if (static_cast<int32_t>(command.hp) < 0) throw std::runtime_error(std::string(io::SpawnSwordsman::Name) + ": hp cannot be negative");
+		if (static_cast<int32_t>(command.strength) < 0) throw std::runtime_error(std::string(io::SpawnSwordsman::Name) + ": strength cannot be negative");
+		apply(command);
+	}
+
+	void SimulationRunner::apply(io::SpawnSwordsman command) {
+		if (!_world) throw std::runtime_error("Map is not created yet");
+		auto unit = features::createSwordsman(
+			_world->pool(),
+			command.unitId,
+			core::Coord{static_cast<int32_t>(command.x), static_cast<int32_t>(command.y)},
+			static_cast<int32_t>(command.hp),
+			static_cast<int32_t>(command.strength));
+		_world->spawn(std::move(unit));
+		_eventLog.log(_tick, io::UnitSpawned{command.unitId, "Swordsman", command.x, command.y});
+	}
+
+	// Создание охотника
+	void SimulationRunner::handle(io::SpawnHunter command) {
+		if (!_world) throw std::runtime_error("Map is not created yet");
+		if (static_cast<int32_t>(command.hp) < 0) throw std::runtime_error(std::string(io::SpawnHunter::Name) + ": hp cannot be negative");
+		if (static_cast<int32_t>(command.agility) < 0) throw std::runtime_error(std::string(io::SpawnHunter::Name) + ": agility cannot be negative");
+		if (static_cast<int32_t>(command.strength) < 0) throw std::runtime_error(std::string(io::SpawnHunter::Name) + ": strength cannot be negative");
+		if (static_cast<int32_t>(command.range) < 0) throw std::runtime_error(std::string(io::SpawnHunter::Name) + ": range cannot be negative");
+		apply(command);
+	}
+
+	void SimulationRunner::apply(io::SpawnHunter command) {
+		if (!_world) throw std::runtime_error("Map is not created yet");
+		auto unit = features::createHunter(
+			_world->pool(),
+			command.unitId,
+			core::Coord{static_cast<int32_t>(command.x), static_cast<int32_t>(command.y)},
+			static_cast<int32_t>(command.hp),
+			static_cast<int32_t>(command.agility),
+			static_cast<int32_t>(command.strength),
+			static_cast<int32_t>(command.range));
+		_world->spawn(std::move(unit));
+		_eventLog.log(_tick, io::UnitSpawned{command.unitId, "Hunter", command.x, command.y});
+	}
+
+	// Добавляем команду марша
+	void SimulationRunner::handle(io::March command) {
+		if (!_world) throw std::runtime_error("Map is not created yet");
+		if (!_world->getUnitPosition(command.unitId)) throw std::runtime_error("Unknown unit id in MARCH");
+		const core::Coord target{static_cast<int32_t>(command.targetX), static_cast<int32_t>(command.targetY)};
+		if (!_world->map().inBounds(target))
+			throw std::runtime_error("MARCH target is out of map bounds");
+		apply(command);
+	}
+
+	void SimulationRunner::apply(io::March command) {
+		if (!_world) throw std::runtime_error("Map is not created yet");
+		const core::Coord from = _world->getUnitPosition(command.unitId).value_or(core::Coord{});
+		const core::Coord target{static_cast<int32_t>(command.targetX), static_cast<int32_t>(command.targetY)};
+		_world->setUnitMarchTarget(command.unitId, target);
+		_eventLog.log(_tick, io::MarchStarted{
+							 command.unitId,
+							 static_cast<uint32_t>(from.x),
+							 static_cast<uint32_t>(from.y),
+							 command.targetX,
+							 command.targetY,
+						 });
+	}
+
+	template <class TFormation>
+	void SimulationRunner::validateFormation(const TFormation& command) const {
+		const std::string name = TFormation::Name;
+		if (!_world) throw std::runtime_error("Map is not created yet");
+		if (command.width == 0 || command.height == 0) throw std::runtime_error(name + ": formation cannot be empty");
+		if (command.spacing == 0) throw std::runtime_error(name + ": spacing must be positive");
+
+		const uint64_t count = uint64_t{command.width} * command.height;
+		if (uint64_t{command.firstUnitId} + count - 1 > std::numeric_limits<uint32_t>::max())
+			throw std::runtime_error(name + ": unit ids overflow");
+		const uint64_t lastX = uint64_t{command.x} + uint64_t{command.width - 1} * command.spacing;
+		const uint64_t lastY = uint64_t{command.y} + uint64_t{command.height - 1} * command.spacing;
+		if (lastX >= _world->map().width() || lastY >= _world->map().height())
+			throw std::runtime_error(name + ": formation is out of map bounds");
+	}
+
+	template <class TFormation, class TFactory>
+	void SimulationRunner::spawnFormation(const TFormation& command, const char* unitType, TFactory&& createUnit) {
+		// Проверка и здесь, а не только в handle: двоичный сценарий применяется без handle
+		validateFormation(command);
 
-		// Создание охотника
-		_parser.add<io::SpawnHunter>([this](io::SpawnHunter command) {
-			if (!_world) throw std::runtime_error("Map is not created yet");
-			const int32_t hp = static_cast<int32_t>(command.hp);
-			const int32_t agility = static_cast<int32_t>(command.agility);
-			const int32_t strength = static_cast<int32_t>(command.strength);
-			const int32_t range = static_cast<int32_t>(command.range);
-			if (hp < 0) throw std::runtime_error(std::string(io::SpawnHunter::Name) + ": hp cannot be negative");
-			if (agility < 0) throw std::runtime_error(std::string(io::SpawnHunter::Name) + ": agility cannot be negative");
-			if (strength < 0) throw std::runtime_error(std::string(io::SpawnHunter::Name) + ": strength cannot be negative");
-			if (range < 0) throw std::runtime_error(std::string(io::SpawnHunter::Name) + ": range cannot be negative");
-			auto unit = features::createHunter(
-				command.unitId,
-				core::Coord{static_cast<int32_t>(command.x), static_cast<int32_t>(command.y)},
-				hp,
-				agility,
-				strength,
-				range);
-			_world->spawn(std::move(unit));
-			_eventLog.log(_tick, io::UnitSpawned{command.unitId, "Hunter", command.x, command.y});
+		std::vector<core::PoolPtr<core::Unit>> units;
+		units.reserve(static_cast<size_t>(command.width) * command.height);
+		uint32_t unitId = command.firstUnitId;
+		for (uint32_t row = 0; row < command.height; ++row) {
+			for (uint32_t column = 0; column < command.width; ++column) {
+				const core::Coord position{
+					static_cast<int32_t>(command.x + column * command.spacing),
+					static_cast<int32_t>(command.y + row * command.spacing),
+				};
+				units.push_back(createUnit(unitId++, position));
+			}
+		}
+		_world->spawn(std::move(units));
+
+		if (!_eventLog.enabled<io::UnitSpawned>(_tick))
+			return;
+		unitId = command.firstUnitId;
+		for (uint32_t row = 0; row < command.height; ++row) {
+			for (uint32_t column = 0; column < command.width; ++column)
+				_eventLog.log(_tick, io::UnitSpawned{unitId++, unitType, command.x + column * command.spacing, command.y + row * command.spacing});
+		}
+	}
+
+	// Строй мечников
+	void SimulationRunner::handle(io::SpawnSwordsmanFormation command) {
+		if (static_cast<int32_t>(command.hp) < 0) throw std::runtime_error(std::string(io::SpawnSwordsmanFormation::Name) + ": hp cannot be negative");
+		if (static_cast<int32_t>(command.strength) < 0) throw std::runtime_error(std::string(io::SpawnSwordsmanFormation::Name) + ": strength cannot be negative");
+		apply(command);
+	}
+
+	void SimulationRunner::apply(io::SpawnSwordsmanFormation command) {
+		spawnFormation(command, "Swordsman", [&](uint32_t unitId, core::Coord position) {
+			return features::createSwordsman(
+				_world->pool(),
+				unitId,
+				position,
+				static_cast<int32_t>(command.hp),
+				static_cast<int32_t>(command.strength));
 		});
+	}
+
+	// Строй охотников
+	void SimulationRunner::handle(io::SpawnHunterFormation command) {
+		if (static_cast<int32_t>(command.hp) < 0) throw std::runtime_error(std::string(io::SpawnHunterFormation::Name) + ": hp cannot be negative");
+		if (static_cast<int32_t>(command.agility) < 0) throw std::runtime_error(std::string(io::SpawnHunterFormation::Name) + ": agility cannot be negative");
+		if (static_cast<int32_t>(command.strength) < 0) throw std::runtime_error(std::string(io::SpawnHunterFormation::Name) + ": strength cannot be negative");
+		if (static_cast<int32_t>(command.range) < 0) throw std::runtime_error(std::string(io::SpawnHunterFormation::Name) + ": range cannot be negative");
+		apply(command);
+	}
 
-		// Добавляем команду марша
-		_parser.add<io::March>([this](io::March command) {
-			if (!_world) throw std::runtime_error("Map is not created yet");
-			std::optional<core::Coord> from = _world->getUnitPosition(command.unitId);
-			if (!from) throw std::runtime_error("Unknown unit id in MARCH");
-
-			const core::Coord target{static_cast<int32_t>(command.targetX), static_cast<int32_t>(command.targetY)};
-			if (!_world->map().inBounds(target))
-				throw std::runtime_error("MARCH target is out of map bounds");
-			_world->setUnitMarchTarget(command.unitId, target);
-			_eventLog.log(_tick, io::MarchStarted{
-								 command.unitId,
-								 static_cast<uint32_t>(from->x),
-								 static_cast<uint32_t>(from->y),
-								 command.targetX,
-								 command.targetY,
-							 });
+	void SimulationRunner::apply(io::SpawnHunterFormation command) {
+		spawnFormation(command, "Hunter", [&](uint32_t unitId, core::Coord position) {
+			return features::createHunter(
+				_world->pool(),
+				unitId,
+				position,
+				static_cast<int32_t>(command.hp),
+				static_cast<int32_t>(command.agility),
+				static_cast<int32_t>(command.strength),
+				static_cast<int32_t>(command.range));
 		});
 	}
 }
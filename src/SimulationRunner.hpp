@@ -1,27 +1,225 @@
 #pragma once
 
+#include <Core/RandomSource.hpp>
+#include <Core/StateCycleDetector.hpp>
 #include <Core/World.hpp>
+#include <IO/Commands/CreateMap.hpp>
+#include <IO/Commands/March.hpp>
+#include <IO/Commands/SpawnHunter.hpp>
+#include <IO/Commands/SpawnHunterFormation.hpp>
+#include <IO/Commands/SpawnSwordsman.hpp>
+#include <IO/Commands/SpawnSwordsmanFormation.hpp>
 #include <IO/System/CommandParser.hpp>
 #include <IO/System/EventLog.hpp>
+#include <Render/IRenderer.hpp>
+#include <Shard/ShardedTicks.hpp>
+#include <Telemetry/ProgressCounters.hpp>
 
+#include <chrono>
+#include <cstddef>
 #include <cstdint>
+#include <iostream>
 #include <istream>
 #include <memory>
+#include <optional>
+#include <ostream>
+#include <string_view>
+#include <vector>
 
 namespace sw {
 
+	// Причина остановки симуляции
+	enum class TerminationReason {
+		// Живых юнитов осталось не больше одного
+		LastUnitStanding,
+		// За ход никто не смог действовать
+		NoActions,
+		// Мир вернулся в уже встречавшееся состояние
+		RepeatedState,
+		// Достигнут предел количества ходов
+		TickCap,
+	};
+
+	const char* terminationReasonName(TerminationReason reason);
+
+	// Итог боя для режима --summary
+	struct BattleSummary {
+		struct Survivor {
+			uint32_t unitId{};
+			int32_t hp{};
+		};
+
+		uint64_t ticks{};
+		TerminationReason reason{};
+		std::vector<Survivor> survivors;
+		// Все юниты в порядке создания, включая погибших
+		std::vector<core::UnitStats> units;
+	};
+
+	void printSummary(std::ostream& stream, const BattleSummary& summary);
+
 	class SimulationRunner {
 
 	public:
-		SimulationRunner();
+		static constexpr uint64_t kDefaultTickCap = 10000;
+
+		// События боя выводятся в eventStream; при нескольких боях в одном процессе у каждого свой поток
+		explicit SimulationRunner(std::ostream& eventStream = std::cout)
+			: _eventLog(eventStream)
+		{}
+
+		// Загрузка сценария и симуляция
 		void run(std::istream& stream);
 
+		// Загрузка текстового сценария с проверкой команд
+		void load(std::istream& stream);
+		// То же для текста в памяти: строки разбираются на нескольких потоках, команды применяются по порядку
+		void load(std::string_view text);
+		// Загрузка сценария, скомпилированного compile: команды уже проверены
+		void loadCompiled(const std::byte* data, size_t size);
+		// Проверяет текстовый сценарий и записывает его в двоичном виде
+		void compile(std::istream& stream, std::ostream& out);
+
+		// Симуляция до конца боя
+		void simulate();
+
+		// Пошаговое выполнение для встраивания: загруженный бой продвигается порциями, между которыми
+		// можно читать состояние. step выполняет не больше ticks ходов, runUntil — ходы, пока не наступит deadline
+		// (ход не прерывается, поэтому deadline может быть превышен на длительность одного хода).
+		// Обе возвращают число выполненных ходов; 0 — бой уже закончен
+		uint64_t step(uint64_t ticks = 1);
+		uint64_t runUntil(std::chrono::steady_clock::time_point deadline);
+
+		// Предел номера хода, на котором бой останавливается с TerminationReason::TickCap.
+		// Увеличение предела продолжает бой, уже остановленный по нему
+		void setTickCap(uint64_t tickCap);
+
+		uint64_t tickCap() const {
+			return _tickCap;
+		}
+
+		// Номер последнего выполненного хода
+		uint64_t tick() const {
+			return _tick;
+		}
+
+		bool finished() const {
+			return _finished;
+		}
+
+		// Причина остановки; имеет смысл, когда finished()
+		TerminationReason terminationReason() const {
+			return _terminationReason;
+		}
+
+		// Состояние мира между ходами; до CREATE_MAP бросает исключение.
+		// С шардированием юниты между ходами остаются в шардах, и мир сначала собирают gather
+		// (законченный бой уже собран); иначе — исключение
+		const core::World& world() const;
+
+		// Возвращает юнитов из шардов в основной мир. Разбиение сохраняется (ShardedTicks::dissolve),
+		// поэтому сборка между ходами не меняет хода боя. Без шардирования ничего не делает
+		void gather();
+
+		EventLog& eventLog() {
+			return _eventLog;
+		}
+
+		// Отрисовка карты: начальный кадр перед первым ходом, затем изменившиеся клетки после каждого хода
+		void setRenderer(std::unique_ptr<render::IRenderer> renderer) {
+			_renderer = std::move(renderer);
+		}
+
+		// Независимые группы юнитов ходят на threads потоках (shard::ShardedTicks); 0 — выключено.
+		// Лог не зависит от числа потоков (в том числе от threads = 1), но отличается от лога без шардирования:
+		// случайный выбор целей берется из потока с ключом (core::RandomSource), а поиск пути видит чужие группы
+		// по снимку на начало хода. С отрисовкой шардирование не используется. Задается до первого хода
+		void setShardThreads(size_t threads) {
+			_shardThreads = threads;
+		}
+
+		// Случайный выбор целей из потока с этим ключом (core::RandomSource), а не из общего std::rand.
+		// Нужен, когда в процессе идут несколько боев на разных потоках (host::BattleScheduler):
+		// std::rand общий для всех и не потокобезопасен. Задается до первого хода
+		void setRandomKey(uint64_t key) {
+			_randomKey = key;
+		}
+
+		// Порядок клеток в тайлах карты (core::CellLayout); на ход боя не влияет. Задается до CREATE_MAP
+		void setCellLayout(core::CellLayout layout) {
+			_cellLayout = layout;
+		}
+
+		// Ход, число живых юнитов и событий; обновляются в начале каждого хода, читать можно из любого потока
+		const telemetry::ProgressCounters& progress() const {
+			return _progress;
+		}
+
+		// Итог последнего вызова run; как и world, требует собранного мира
+		BattleSummary summary() const;
+
+		// Для команд сценария сверх встроенных
+		io::CommandParser& parser() {
+			return _parser;
+		}
+
 	private:
-		void setupParser();
+		// Встроенные команды сценария: handle проверяет команду и вызывает apply
+		void handle(io::CreateMap command);
+		void handle(io::SpawnSwordsman command);
+		void handle(io::SpawnHunter command);
+		void handle(io::March command);
+		void handle(io::SpawnSwordsmanFormation command);
+		void handle(io::SpawnHunterFormation command);
+		void apply(io::CreateMap command);
+		void apply(io::SpawnSwordsman command);
+		void apply(io::SpawnHunter command);
+		void apply(io::March command);
+		void apply(io::SpawnSwordsmanFormation command);
+		void apply(io::SpawnHunterFormation command);
+
+		// Общие проверки строя: непустой, шаг положительный, id не переполняются, все клетки на карте
+		template <class TFormation>
+		void validateFormation(const TFormation& command) const;
+		// Проверяет строй (validateFormation), создает его юнитов через пакетный World::spawn и логирует их появление
+		template <class TFormation, class TFactory>
+		void spawnFormation(const TFormation& command, const char* unitType, TFactory&& createUnit);
+
+		void start();
+		void checkFinished();
+		void advanceTick();
+		// Пропускает до maxTicks ходов, в которых все бодрствующие юниты только идут (core::World::planMarchSkip).
+		// Лог и итог те же, что у advanceTick на каждом ходу. Возвращает число пропущенных ходов; 0 — нужен advanceTick
+		uint64_t skipMarchTicks(uint64_t maxTicks);
+		void logMarchSkip(uint64_t turns);
+		void publishProgress(size_t aliveUnits);
+		// Пока юниты в шардах, основной мир пуст: world и summary бросают исключение
+		void requireGathered() const;
+		size_t aliveUnitsCount() const;
+		uint64_t stateHash() const;
 
 		uint64_t _tick = 1;
+		uint64_t _tickCap = kDefaultTickCap;
+		bool _started = false;
+		bool _finished = false;
+		// Хеши состояний мира на границах выполненных ходов
+		core::StateCycleDetector _seenStates;
+		TerminationReason _terminationReason = TerminationReason::LastUnitStanding;
 		io::CommandParser _parser;
 		EventLog _eventLog;
 		std::unique_ptr<core::World> _world;
+		core::CellLayout _cellLayout{};
+		// Буфер окрестности текущего юнита
+		core::Perception _perception;
+		core::RandomSource _random;
+		std::optional<uint64_t> _randomKey;
+		size_t _shardThreads{};
+		std::unique_ptr<shard::ShardedTicks> _shards;
+		std::unique_ptr<render::IRenderer> _renderer;
+		// План пропуска ходов (буферы переиспользуются) и ход следующей попытки после неудачной
+		core::MarchSkip _marchSkip;
+		uint64_t _nextMarchSkip{};
+		uint64_t _marchSkipDelay{1};
+		telemetry::ProgressCounters _progress;
 	};
 }
@@ -0,0 +1,16 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+namespace sw::telemetry {
+
+	// Счетчики хода симуляции, которые читает поток телеметрии.
+	// Поток симуляции только сохраняет значения с memory_order_relaxed: согласованность между счетчиками не нужна
+	struct ProgressCounters {
+		std::atomic<uint64_t> tick{};
+		std::atomic<uint64_t> aliveUnits{};
+		// Событий, прошедших фильтр лога, с начала работы
+		std::atomic<uint64_t> events{};
+	};
+}
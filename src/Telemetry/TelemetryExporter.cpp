@@ -0,0 +1,209 @@
+#include "TelemetryExporter.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#define SW_HAS_UNIX_SOCKETS 1
+#endif
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+
+namespace sw::telemetry {
+
+	namespace {
+		constexpr std::string_view kSocketPrefix = "unix:";
+
+		double perSecond(uint64_t delta, std::chrono::steady_clock::duration elapsed) {
+			const double seconds = std::chrono::duration<double>(elapsed).count();
+			return seconds > 0 ? static_cast<double>(delta) / seconds : 0.0;
+		}
+
+		void metric(std::ostream& out, const char* name, const char* type, const char* help, auto value) {
+			out << "# HELP " << name << ' ' << help << '\n';
+			out << "# TYPE " << name << ' ' << type << '\n';
+			out << name << ' ' << value << '\n';
+		}
+	}
+
+	uint64_t residentMemoryBytes() {
+#if defined(__linux__)
+		// Второе поле /proc/self/statm — резидентные страницы
+		std::ifstream statm("/proc/self/statm");
+		uint64_t totalPages = 0;
+		uint64_t residentPages = 0;
+		if (statm >> totalPages >> residentPages)
+			return residentPages * static_cast<uint64_t>(::sysconf(_SC_PAGESIZE));
+#endif
+		return 0;
+	}
+
+	TelemetryExporter::TelemetryExporter(const ProgressCounters& counters, std::string target, std::chrono::milliseconds interval)
+		: _counters(counters)
+		, _interval(interval)
+	{
+		if (_interval.count() <= 0)
+			throw std::runtime_error("Telemetry interval must be positive");
+
+		if (std::string_view(target).starts_with(kSocketPrefix)) {
+			_socket = true;
+			_path = target.substr(kSocketPrefix.size());
+		} else {
+			_path = std::move(target);
+		}
+		if (_path.empty())
+			throw std::runtime_error("Error: Telemetry target is empty");
+
+		if (_socket) {
+#ifdef SW_HAS_UNIX_SOCKETS
+			sockaddr_un address{};
+			address.sun_family = AF_UNIX;
+			if (_path.size() >= sizeof(address.sun_path))
+				throw std::runtime_error("Error: Telemetry socket path is too long - " + _path);
+			std::memcpy(address.sun_path, _path.c_str(), _path.size() + 1);
+
+			_listenFd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+			if (_listenFd < 0)
+				throw std::runtime_error("Error: Cannot create telemetry socket");
+			// Сокет от прошлого запуска мешает bind
+			::unlink(_path.c_str());
+			if (::bind(_listenFd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0 || ::listen(_listenFd, 16) != 0) {
+				::close(_listenFd);
+				throw std::runtime_error("Error: Cannot listen on telemetry socket - " + _path);
+			}
+#else
+			throw std::runtime_error("Error: Unix sockets are not supported on this platform");
+#endif
+		}
+
+		_previous = takeSample();
+		_thread = std::thread([this] { run(); });
+	}
+
+	TelemetryExporter::~TelemetryExporter() {
+		stop();
+	}
+
+	void TelemetryExporter::stop() {
+		{
+			std::lock_guard lock(_mutex);
+			if (_stopping)
+				return;
+			_stopping = true;
+		}
+		_wake.notify_one();
+		if (_thread.joinable())
+			_thread.join();
+#ifdef SW_HAS_UNIX_SOCKETS
+		if (_listenFd >= 0) {
+			::close(_listenFd);
+			::unlink(_path.c_str());
+			_listenFd = -1;
+		}
+#endif
+	}
+
+	TelemetryExporter::Sample TelemetryExporter::takeSample() const {
+		return Sample{
+			_counters.tick.load(std::memory_order_relaxed),
+			_counters.aliveUnits.load(std::memory_order_relaxed),
+			_counters.events.load(std::memory_order_relaxed),
+			std::chrono::steady_clock::now(),
+		};
+	}
+
+	std::string TelemetryExporter::format(const Sample& sample) const {
+		const auto elapsed = sample.time - _previous.time;
+		std::ostringstream out;
+		metric(out, "sw_tick", "gauge", "Current simulation tick.", sample.tick);
+		metric(out, "sw_alive_units", "gauge", "Units alive at the start of the current tick.", sample.aliveUnits);
+		metric(out, "sw_events_total", "counter", "Events that passed the event log filter.", sample.events);
+		metric(out, "sw_events_per_second", "gauge", "Logged events per second over the last interval.", perSecond(sample.events - _previous.events, elapsed));
+		metric(out, "sw_ticks_per_second", "gauge", "Simulated ticks per second over the last interval.", perSecond(sample.tick - _previous.tick, elapsed));
+		metric(out, "sw_resident_memory_bytes", "gauge", "Resident set size of the process.", residentMemoryBytes());
+		return std::move(out).str();
+	}
+
+	void TelemetryExporter::writeFile(const std::string& text) const {
+		const std::string temporary = _path + ".tmp";
+		{
+			std::ofstream file(temporary, std::ios::trunc);
+			if (!(file << text))
+				return;
+		}
+		std::error_code error;
+		std::filesystem::rename(temporary, _path, error);
+	}
+
+	void TelemetryExporter::run() {
+		std::string text = format(_previous);
+		for (bool last = false; !last;) {
+			const auto due = std::chrono::steady_clock::now() + _interval;
+			if (_socket) {
+				serveClients(text, due);
+			} else {
+				writeFile(text);
+			}
+
+			{
+				std::unique_lock lock(_mutex);
+				_wake.wait_until(lock, due, [this] { return _stopping; });
+				last = _stopping;
+			}
+
+			const Sample sample = takeSample();
+			text = format(sample);
+			_previous = sample;
+		}
+		// Итоговый снимок после остановки
+		if (!_socket)
+			writeFile(text);
+	}
+
+	// Отвечает подключениям до момента until или до остановки
+	void TelemetryExporter::serveClients(const std::string& text, std::chrono::steady_clock::time_point until) {
+#ifdef SW_HAS_UNIX_SOCKETS
+		constexpr auto kPollStep = std::chrono::milliseconds(50);
+		while (true) {
+			{
+				std::lock_guard lock(_mutex);
+				if (_stopping)
+					return;
+			}
+			const auto now = std::chrono::steady_clock::now();
+			if (now >= until)
+				return;
+			const auto wait = std::min<std::chrono::steady_clock::duration>(until - now, kPollStep);
+
+			pollfd descriptor{_listenFd, POLLIN, 0};
+			const int ready = ::poll(&descriptor, 1, static_cast<int>(std::chrono::ceil<std::chrono::milliseconds>(wait).count()));
+			if (ready <= 0 || !(descriptor.revents & POLLIN))
+				continue;
+			const int client = ::accept(_listenFd, nullptr, nullptr);
+			if (client < 0)
+				continue;
+			size_t written = 0;
+			while (written < text.size()) {
+				const ssize_t n = ::send(client, text.data() + written, text.size() - written, MSG_NOSIGNAL);
+				if (n <= 0)
+					break;
+				written += static_cast<size_t>(n);
+			}
+			::close(client);
+		}
+#else
+		(void)text;
+		(void)until;
+#endif
+	}
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include "ProgressCounters.hpp"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace sw::telemetry {
+
+	// Фоновый поток, раз в interval снимающий ProgressCounters и отдающий их в текстовом формате Prometheus.
+	// Цель — файл (перезаписывается целиком через переименование, читатель не видит половину) или,
+	// с префиксом "unix:", Unix-сокет: каждому подключившемуся отдается последний снимок, после чего соединение закрывается
+	class TelemetryExporter {
+	public:
+		static constexpr std::chrono::milliseconds kDefaultInterval{1000};
+
+		TelemetryExporter(const ProgressCounters& counters, std::string target, std::chrono::milliseconds interval = kDefaultInterval);
+		~TelemetryExporter();
+
+		TelemetryExporter(const TelemetryExporter&) = delete;
+		TelemetryExporter& operator=(const TelemetryExporter&) = delete;
+
+		// Снимает последний снимок и останавливает поток
+		void stop();
+
+	private:
+		struct Sample {
+			uint64_t tick{};
+			uint64_t aliveUnits{};
+			uint64_t events{};
+			std::chrono::steady_clock::time_point time;
+		};
+
+		void run();
+		Sample takeSample() const;
+		std::string format(const Sample& sample) const;
+		void writeFile(const std::string& text) const;
+		void serveClients(const std::string& text, std::chrono::steady_clock::time_point until);
+
+		const ProgressCounters& _counters;
+		std::string _path;
+		bool _socket = false;
+		int _listenFd = -1;
+		std::chrono::milliseconds _interval;
+		Sample _previous;
+
+		std::mutex _mutex;
+		std::condition_variable _wake;
+		bool _stopping = false;
+		std::thread _thread;
+	};
+
+	// Резидентная память процесса в байтах; 0, если узнать нельзя
+	uint64_t residentMemoryBytes();
+}
@@ -1,26 +1,268 @@
+#include <IO/Events/MapCreated.hpp>
+#include <IO/Events/MarchEnded.hpp>
+#include <IO/Events/MarchStarted.hpp>
+#include <IO/Events/UnitAttacked.hpp>
+#include <IO/Events/UnitDied.hpp>
+#include <IO/Events/UnitMoved.hpp>
+#include <IO/Events/UnitSpawned.hpp>
+#include <IO/System/CompiledScenario.hpp>
+#include <IO/System/EventFilter.hpp>
+#include <IO/System/MappedFile.hpp>
+#include <Render/AnsiRenderer.hpp>
+#include <Render/PpmRenderer.hpp>
+#include <Replay/KeyframeIndex.hpp>
 #include <SimulationRunner.hpp>
+#include <Telemetry/TelemetryExporter.hpp>
 
+#include <algorithm>
+#include <array>
+#include <charconv>
 #include <ctime>
+#include <cstdint>
 #include <cstdlib>
 #include <fstream>
 #include <iostream>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <sstream>
 #include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace {
+
+	constexpr std::array<std::string_view, 7> kEventNames{
+		sw::io::MapCreated::Name,
+		sw::io::MarchEnded::Name,
+		sw::io::MarchStarted::Name,
+		sw::io::UnitAttacked::Name,
+		sw::io::UnitDied::Name,
+		sw::io::UnitMoved::Name,
+		sw::io::UnitSpawned::Name,
+	};
+
+	std::vector<std::string> splitList(std::string_view list) {
+		std::vector<std::string> items;
+		while (!list.empty()) {
+			const size_t comma = list.find(',');
+			const std::string_view item = list.substr(0, comma);
+			if (!item.empty())
+				items.emplace_back(item);
+			list = comma == std::string_view::npos ? std::string_view{} : list.substr(comma + 1);
+		}
+		return items;
+	}
+
+	template <class T>
+	T parseNumber(std::string_view text, std::string_view option) {
+		T value{};
+		const auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+		if (error != std::errc{} || end != text.data() + text.size())
+			throw std::runtime_error("Error: Invalid number '" + std::string(text) + "' in " + std::string(option));
+		return value;
+	}
+
+	// --events=UNIT_DIED,MARCH_ENDED --units=1,2 --ticks=10:200 (любую границу диапазона можно опустить)
+	bool parseFilterOption(const std::string& arg, sw::EventFilter& filter) {
+		const size_t eq = arg.find('=');
+		const std::string_view option = std::string_view(arg).substr(0, eq);
+		const std::string_view value = eq == std::string::npos ? std::string_view{} : std::string_view(arg).substr(eq + 1);
+
+		if (option == "--events") {
+			std::vector<std::string> names = splitList(value);
+			for (const std::string& name : names) {
+				if (std::find(kEventNames.begin(), kEventNames.end(), name) == kEventNames.end())
+					throw std::runtime_error("Error: Unknown event type - " + name);
+			}
+			filter.allowTypes(names);
+			return true;
+		}
+		if (option == "--units") {
+			std::vector<uint32_t> unitIds;
+			for (const std::string& id : splitList(value))
+				unitIds.push_back(parseNumber<uint32_t>(id, option));
+			filter.allowUnits(unitIds);
+			return true;
+		}
+		if (option == "--ticks") {
+			const size_t colon = value.find(':');
+			if (colon == std::string_view::npos)
+				throw std::runtime_error("Error: --ticks expects FROM:TO");
+			const std::string_view from = value.substr(0, colon);
+			const std::string_view to = value.substr(colon + 1);
+			filter.setTickRange(
+				from.empty() ? 0 : parseNumber<uint64_t>(from, option),
+				to.empty() ? std::numeric_limits<uint64_t>::max() : parseNumber<uint64_t>(to, option));
+			return true;
+		}
+		return false;
+	}
+}
 
 int main(int argc, char** argv) {
 	std::srand(static_cast<unsigned>(std::time(nullptr)));
 
 	try {
-		if (argc != 2) {
+		// Использование:
+		//   sw_battle_test [--async-log] [--summary] [--events=...] [--units=...] [--ticks=FROM:TO] <файл сценария>
+		//   sw_battle_test [--render-ansi=<файл>] [--render-ppm=<префикс> [--render-full-frame=N]] <файл сценария>
+		//   sw_battle_test [--tick-cap=N] [--shard-threads=N] [--cell-layout=row-major|morton] <файл сценария>
+		//   sw_battle_test [--telemetry=<файл>|--telemetry=unix:<сокет>] <файл сценария>
+		//   sw_battle_test --compile=<двоичный файл> <файл сценария>
+		//   sw_battle_test --replay-at=TICK [--keyframe-interval=N] <файл лога>
+		// Вместо текстового сценария можно передать скомпилированный
+		std::string scenarioPath;
+		std::string compiledPath;
+		bool asyncLog = false;
+		bool summary = false;
+		uint64_t tickCap = sw::SimulationRunner::kDefaultTickCap;
+		size_t shardThreads = 0;
+		sw::core::CellLayout cellLayout = sw::core::CellLayout::RowMajor;
+		std::string telemetryTarget;
+		std::string ansiPath;
+		std::string ppmPrefix;
+		uint64_t fullFrameInterval = sw::render::PpmRenderer::kDefaultFullFrameInterval;
+		std::optional<uint64_t> replayTick;
+		uint64_t keyframeInterval = sw::replay::KeyframeIndex::kDefaultInterval;
+		sw::EventFilter filter;
+		for (int i = 1; i < argc; ++i) {
+			const std::string arg = argv[i];
+			if (arg == "--async-log") {
+				asyncLog = true;
+			} else if (arg == "--summary") {
+				summary = true;
+			} else if (arg.starts_with("--compile=")) {
+				compiledPath = arg.substr(10);
+				if (compiledPath.empty())
+					throw std::runtime_error("Error: --compile expects an output file");
+			} else if (arg.starts_with("--tick-cap=")) {
+				tickCap = parseNumber<uint64_t>(std::string_view(arg).substr(11), "--tick-cap");
+			} else if (arg.starts_with("--shard-threads=")) {
+				shardThreads = parseNumber<size_t>(std::string_view(arg).substr(16), "--shard-threads");
+			} else if (arg.starts_with("--cell-layout=")) {
+				const std::string layout = arg.substr(14);
+				if (layout == "row-major") {
+					cellLayout = sw::core::CellLayout::RowMajor;
+				} else if (layout == "morton") {
+					cellLayout = sw::core::CellLayout::Morton;
+				} else {
+					throw std::runtime_error("Error: --cell-layout expects row-major or morton");
+				}
+			} else if (arg.starts_with("--telemetry=")) {
+				telemetryTarget = arg.substr(12);
+				if (telemetryTarget.empty())
+					throw std::runtime_error("Error: --telemetry expects a file or unix:<socket>");
+			} else if (arg.starts_with("--render-ansi=")) {
+				ansiPath = arg.substr(14);
+				if (ansiPath.empty())
+					throw std::runtime_error("Error: --render-ansi expects an output file");
+			} else if (arg.starts_with("--render-ppm=")) {
+				ppmPrefix = arg.substr(13);
+				if (ppmPrefix.empty())
+					throw std::runtime_error("Error: --render-ppm expects a file prefix");
+			} else if (arg.starts_with("--render-full-frame=")) {
+				fullFrameInterval = parseNumber<uint64_t>(std::string_view(arg).substr(20), "--render-full-frame");
+				if (fullFrameInterval == 0)
+					throw std::runtime_error("Error: --render-full-frame must be positive");
+			} else if (arg.starts_with("--replay-at=")) {
+				replayTick = parseNumber<uint64_t>(std::string_view(arg).substr(12), "--replay-at");
+			} else if (arg.starts_with("--keyframe-interval=")) {
+				keyframeInterval = parseNumber<uint64_t>(std::string_view(arg).substr(20), "--keyframe-interval");
+				if (keyframeInterval == 0)
+					throw std::runtime_error("Error: --keyframe-interval must be positive");
+			} else if (parseFilterOption(arg, filter)) {
+				continue;
+			} else if (arg.starts_with("--")) {
+				throw std::runtime_error("Error: Unknown option - " + arg);
+			} else if (scenarioPath.empty()) {
+				scenarioPath = arg;
+			} else {
+				throw std::runtime_error("Error: Only one scenario file can be specified");
+			}
+		}
+		if (scenarioPath.empty()) {
 			throw std::runtime_error("Error: No file specified in command line argument");
 		}
+		if (!ansiPath.empty() && !ppmPrefix.empty()) {
+			throw std::runtime_error("Error: --render-ansi and --render-ppm are mutually exclusive");
+		}
+
+		// Восстановление состояния на заданный ход по записанному логу событий
+		if (replayTick) {
+			sw::replay::printReplayState(std::cout, sw::replay::seekReplay(scenarioPath, *replayTick, keyframeInterval));
+			return 0;
+		}
+
+		// Проверка текстового сценария и запись его в двоичном виде; события при этом не выводятся
+		if (!compiledPath.empty()) {
+			std::ifstream file(scenarioPath);
+			if (!file) {
+				throw std::runtime_error("Error: File not found - " + scenarioPath);
+			}
+			sw::EventFilter silent;
+			silent.allowTypes({});
+			sw::SimulationRunner runner;
+			runner.eventLog().setFilter(std::move(silent));
+			// Файл создается только для сценария, прошедшего проверку
+			std::ostringstream compiled;
+			runner.compile(file, compiled);
+
+			std::ofstream out(compiledPath, std::ios::binary | std::ios::trunc);
+			const std::string bytes = std::move(compiled).str();
+			if (!out || !out.write(bytes.data(), static_cast<std::streamsize>(bytes.size()))) {
+				throw std::runtime_error("Error: Cannot write file - " + compiledPath);
+			}
+			return 0;
+		}
+
+		sw::io::MappedFile scenario(scenarioPath);
 
-		std::ifstream file(argv[1]);
-		if (!file) {
-			throw std::runtime_error("Error: File not found - " + std::string(argv[1]));
+		// В режиме итога лог событий не нужен: все типы отключены и события даже не создаются
+		if (summary) {
+			filter.allowTypes({});
 		}
 
 		sw::SimulationRunner runner;
-		runner.run(file);
+		runner.eventLog().setFilter(std::move(filter));
+		runner.setTickCap(tickCap);
+		runner.setShardThreads(shardThreads);
+		runner.setCellLayout(cellLayout);
+		if (asyncLog) {
+			runner.eventLog().enableAsync();
+		}
+		// Кадры пишутся в отдельный файл: стандартный вывод занят логом событий
+		std::ofstream ansiStream;
+		if (!ansiPath.empty()) {
+			ansiStream.open(ansiPath, std::ios::binary | std::ios::trunc);
+			if (!ansiStream) {
+				throw std::runtime_error("Error: Cannot write file - " + ansiPath);
+			}
+			runner.setRenderer(std::make_unique<sw::render::AnsiRenderer>(ansiStream));
+		} else if (!ppmPrefix.empty()) {
+			runner.setRenderer(std::make_unique<sw::render::PpmRenderer>(ppmPrefix, fullFrameInterval));
+		}
+		// Поток телеметрии раз в секунду читает счетчики хода; остановится до вывода итога
+		std::optional<sw::telemetry::TelemetryExporter> telemetry;
+		if (!telemetryTarget.empty()) {
+			telemetry.emplace(runner.progress(), telemetryTarget);
+		}
+		if (sw::io::isCompiledScenario(scenario.data(), scenario.size())) {
+			runner.loadCompiled(scenario.data(), scenario.size());
+		} else {
+			runner.load(std::string_view(reinterpret_cast<const char*>(scenario.data()), scenario.size()));
+		}
+		runner.simulate();
+		if (telemetry) {
+			telemetry->stop();
+		}
+
+		if (summary) {
+			runner.eventLog().close();
+			sw::printSummary(std::cout, runner.summary());
+		}
 
 		return 0;
 	} catch (const std::exception& e) {
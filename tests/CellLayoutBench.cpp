@@ -0,0 +1,114 @@
+// Сравнение порядка клеток в тайле (RowMajor и Morton): чтение окрестностей 3x3 карты и целый бой;
+// в сборку по умолчанию не входит:
+//   cmake --build <каталог сборки> --target sw_cell_layout_bench
+#include <Core/Coord.hpp>
+#include <Core/GridMap.hpp>
+#include <IO/System/EventFilter.hpp>
+#include <SimulationRunner.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+
+	constexpr uint32_t kMapSize = 1024;
+	constexpr int kRepeats = 5;
+
+	// Наносекунд на окрестность 3x3 (лучший из kRepeats); сумма идентификаторов — в sink
+	double measureNeighbourhoods(sw::core::CellLayout layout, const std::vector<sw::core::Coord>& centers, int64_t& sink) {
+		sw::core::GridMap map(kMapSize, kMapSize, layout);
+		std::mt19937 random(1);
+		for (uint32_t i = 0; i < kMapSize * kMapSize / 4; ++i)
+			map.setOccupied(sw::core::Coord{static_cast<int32_t>(random() % kMapSize), static_cast<int32_t>(random() % kMapSize)}, static_cast<int32_t>(i));
+
+		double best = 0;
+		for (int repeat = 0; repeat < kRepeats; ++repeat) {
+			const auto start = std::chrono::steady_clock::now();
+			for (const sw::core::Coord& center : centers) {
+				for (int32_t dy = -1; dy <= 1; ++dy) {
+					for (int32_t dx = -1; dx <= 1; ++dx)
+						sink += map.occupantId(sw::core::Coord{center.x + dx, center.y + dy});
+				}
+			}
+			const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+			const double perCenter = elapsed.count() / static_cast<double>(centers.size());
+			if (repeat == 0 || perCenter < best)
+				best = perCenter;
+		}
+		return best;
+	}
+
+	// Плотные строи сходятся в центре карты 200 x 200
+	std::string battleScenario() {
+		std::ostringstream out;
+		out << "CREATE_MAP 200 200\n";
+		out << "SPAWN_SWORDSMAN_FORMATION 1 20 20 60 20 1 20 2\n";
+		out << "SPAWN_HUNTER_FORMATION 2001 20 140 60 20 1 15 2 1 5\n";
+		for (uint32_t i = 0; i < 60; ++i) {
+			out << "MARCH " << 1 + i << " 100 100\n";
+			out << "MARCH " << 2001 + i << " 100 100\n";
+		}
+		return out.str();
+	}
+
+	// Миллисекунд на бой (лучший из kRepeats); события не создаются
+	double measureBattle(sw::core::CellLayout layout, const std::string& text, uint64_t& ticks) {
+		double best = 0;
+		for (int repeat = 0; repeat < kRepeats; ++repeat) {
+			std::srand(1);
+			std::ostringstream events;
+			sw::SimulationRunner runner(events);
+			sw::EventFilter silent;
+			silent.allowTypes({});
+			runner.eventLog().setFilter(std::move(silent));
+			runner.setCellLayout(layout);
+			runner.load(std::string_view(text));
+			const auto start = std::chrono::steady_clock::now();
+			runner.simulate();
+			const std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+			ticks = runner.tick();
+			if (repeat == 0 || elapsed.count() < best)
+				best = elapsed.count();
+		}
+		return best;
+	}
+}
+
+int main() {
+	using sw::core::CellLayout;
+	std::mt19937 random(2);
+	std::vector<sw::core::Coord> centers(1'000'000);
+	for (sw::core::Coord& center : centers)
+		center = sw::core::Coord{static_cast<int32_t>(random() % kMapSize), static_cast<int32_t>(random() % kMapSize)};
+	// Те же центры подряд вдоль строки: соседние окрестности перекрываются
+	std::vector<sw::core::Coord> sweep;
+	for (int32_t y = 0; y < static_cast<int32_t>(kMapSize); y += 8) {
+		for (int32_t x = 0; x < static_cast<int32_t>(kMapSize); ++x)
+			sweep.push_back(sw::core::Coord{x, y});
+	}
+
+	int64_t sink = 0;
+	std::cout << "workload row_major morton\n";
+	std::cout << "random_3x3_ns " << measureNeighbourhoods(CellLayout::RowMajor, centers, sink) << ' ' << measureNeighbourhoods(CellLayout::Morton, centers, sink) << '\n';
+	std::cout << "sweep_3x3_ns " << measureNeighbourhoods(CellLayout::RowMajor, sweep, sink) << ' ' << measureNeighbourhoods(CellLayout::Morton, sweep, sink) << '\n';
+
+	const std::string text = battleScenario();
+	uint64_t rowMajorTicks = 0;
+	uint64_t mortonTicks = 0;
+	const double rowMajor = measureBattle(CellLayout::RowMajor, text, rowMajorTicks);
+	const double morton = measureBattle(CellLayout::Morton, text, mortonTicks);
+	if (rowMajorTicks != mortonTicks) {
+		std::cerr << "Layouts disagree on the battle length\n";
+		return 1;
+	}
+	std::cout << "battle_ms " << rowMajor << ' ' << morton << " (ticks=" << rowMajorTicks << ")\n";
+	return sink == 0 ? 1 : 0;
+}
@@ -0,0 +1,134 @@
+// Порядок клеток в тайле (core::CellLayout) не влияет ни на запросы карты, ни на ход боя:
+// RowMajor и Morton дают одинаковые ответы GridMap и одинаковый лог SimulationRunner
+#include <Core/Coord.hpp>
+#include <Core/GridMap.hpp>
+#include <SimulationRunner.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+
+	int failures = 0;
+
+	void check(bool condition, const std::string& what) {
+		if (condition)
+			return;
+		++failures;
+		std::cerr << "FAILED: " << what << '\n';
+	}
+
+	using Visited = std::vector<std::pair<sw::core::Coord, int32_t>>;
+
+	Visited visit(const sw::core::GridMap& map, const sw::core::Coord& min, const sw::core::Coord& max) {
+		Visited visited;
+		map.forEachOccupiedInRect(min, max, [&](const sw::core::Coord& cell, int32_t occupant) {
+			visited.emplace_back(cell, occupant);
+		});
+		return visited;
+	}
+
+	// Одни и те же занятия и освобождения клеток на картах с разным порядком; размеры не кратны тайлу
+	void compareMaps(std::mt19937& random) {
+		using sw::core::CellLayout;
+		using sw::core::Coord;
+		constexpr uint32_t kWidth = 150;
+		constexpr uint32_t kHeight = 97;
+		sw::core::GridMap rowMajor(kWidth, kHeight, CellLayout::RowMajor);
+		sw::core::GridMap morton(kWidth, kHeight, CellLayout::Morton);
+		check(morton.layout() == CellLayout::Morton, "map keeps the requested layout");
+
+		std::uniform_int_distribution<int32_t> x(0, kWidth - 1);
+		std::uniform_int_distribution<int32_t> y(0, kHeight - 1);
+		for (int step = 0; step < 20000; ++step) {
+			const Coord cell{x(random), y(random)};
+			if (random() % 3 == 0) {
+				rowMajor.clear(cell);
+				morton.clear(cell);
+			} else {
+				const int32_t unitId = static_cast<int32_t>(random() % 1000);
+				rowMajor.setOccupied(cell, unitId);
+				morton.setOccupied(cell, unitId);
+			}
+			if (step % 1000 != 999)
+				continue;
+
+			bool sameCells = true;
+			for (int32_t cy = 0; cy < static_cast<int32_t>(kHeight); ++cy) {
+				for (int32_t cx = 0; cx < static_cast<int32_t>(kWidth); ++cx)
+					sameCells = sameCells && rowMajor.occupantId(Coord{cx, cy}) == morton.occupantId(Coord{cx, cy});
+			}
+			check(sameCells, "occupantId matches after step " + std::to_string(step));
+
+			const Coord center{x(random), y(random)};
+			const int32_t radius = static_cast<int32_t>(random() % 40);
+			const Coord min{center.x - radius, center.y - radius};
+			const Coord max{center.x + radius, center.y + radius};
+			check(visit(rowMajor, min, max) == visit(morton, min, max), "forEachOccupiedInRect matches after step " + std::to_string(step));
+			check(rowMajor.anyOccupiedAround(center) == morton.anyOccupiedAround(center), "anyOccupiedAround matches after step " + std::to_string(step));
+			check(rowMajor.occupiedInRing(center, radius / 2, radius) == morton.occupiedInRing(center, radius / 2, radius), "occupiedInRing matches after step " + std::to_string(step));
+		}
+	}
+
+	// Два строя через несколько тайлов навстречу друг другу, охотники по краям и марширующие в обход
+	std::string scenario(std::mt19937& random) {
+		std::ostringstream out;
+		out << "CREATE_MAP 150 140\n";
+		out << "SPAWN_SWORDSMAN_FORMATION 1 50 50 10 4 1 " << 6 + random() % 6 << " 2\n";
+		out << "SPAWN_HUNTER_FORMATION 101 55 80 8 3 2 " << 5 + random() % 5 << " 2 1 " << 3 + random() % 4 << '\n';
+		uint32_t id = 200;
+		for (int i = 0; i < 30; ++i) {
+			const uint32_t x = static_cast<uint32_t>(random() % 150);
+			const uint32_t y = static_cast<uint32_t>(random() % 40);
+			if (random() % 2 == 0)
+				out << "SPAWN_SWORDSMAN " << id << ' ' << x << ' ' << y << " 8 1\n";
+			else
+				out << "SPAWN_HUNTER " << id << ' ' << x << ' ' << y << " 6 1 1 5\n";
+			out << "MARCH " << id++ << ' ' << random() % 150 << ' ' << 60 + random() % 80 << '\n';
+		}
+		out << "MARCH 1 60 130\n";
+		out << "MARCH 101 120 10\n";
+		return out.str();
+	}
+
+	std::string battle(const std::string& text, sw::core::CellLayout layout, size_t shardThreads) {
+		std::srand(7);
+		std::ostringstream events;
+		{
+			sw::SimulationRunner runner(events);
+			runner.setCellLayout(layout);
+			runner.setShardThreads(shardThreads);
+			runner.load(std::string_view(text));
+			runner.simulate();
+			events << "hash=" << runner.world().stateHash() << '\n';
+			sw::printSummary(events, runner.summary());
+		}
+		return events.str();
+	}
+}
+
+int main() {
+	std::mt19937 random(4);
+	compareMaps(random);
+	for (int i = 0; i < 10; ++i) {
+		const std::string text = scenario(random);
+		for (size_t threads : {size_t{0}, size_t{2}}) {
+			check(battle(text, sw::core::CellLayout::RowMajor, threads) == battle(text, sw::core::CellLayout::Morton, threads),
+				"battle " + std::to_string(i) + " with " + std::to_string(threads) + " shard threads:\n" + text);
+		}
+	}
+
+	if (failures > 0) {
+		std::cerr << failures << " checks failed\n";
+		return 1;
+	}
+	std::cout << "OK\n";
+	return 0;
+}
@@ -0,0 +1,135 @@
+// Разбор текста в памяти кусками на нескольких потоках дает ту же последовательность вызовов handler
+// и ту же ошибку, что разбор потока: куски маленькие, чтобы их было много на небольшом тексте
+#include <IO/Commands/CreateMap.hpp>
+#include <IO/Commands/March.hpp>
+#include <IO/Commands/SpawnHunter.hpp>
+#include <IO/Commands/SpawnSwordsman.hpp>
+#include <IO/System/CommandParser.hpp>
+#include <IO/System/details/PrintFieldVisitor.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+namespace {
+
+	int failures = 0;
+
+	void check(bool condition, const std::string& what) {
+		if (condition)
+			return;
+		++failures;
+		std::cerr << "FAILED: " << what << '\n';
+	}
+
+	using Commands = sw::io::CommandList<sw::io::CreateMap, sw::io::SpawnSwordsman, sw::io::March>;
+
+	// Юнит, на MARCH которого handler бросает исключение, как SimulationRunner на неверной команде
+	constexpr uint32_t kRejectedUnit = 999;
+
+	// Вызовы handler (встроенные команды и зарегистрированные через add) по порядку и текст ошибки
+	class Recorder {
+	public:
+		template <class TCommand>
+		void operator()(TCommand command) {
+			if constexpr (std::is_same_v<TCommand, sw::io::March>) {
+				if (command.unitId == kRejectedUnit)
+					throw std::runtime_error("MARCH of unit " + std::to_string(command.unitId) + " is rejected");
+			}
+			_calls << TCommand::Name << ' ';
+			sw::PrintFieldVisitor visitor(_calls);
+			command.visit(visitor);
+			_calls << '\n';
+		}
+
+		sw::io::CommandParser parser() {
+			sw::io::CommandParser parser;
+			parser.add<sw::io::SpawnHunter>([this](sw::io::SpawnHunter command) { (*this)(command); });
+			return parser;
+		}
+
+		std::string result(const std::function<void()>& parse) {
+			try {
+				parse();
+			} catch (const std::runtime_error& e) {
+				_calls << "error: " << e.what() << '\n';
+			}
+			return _calls.str();
+		}
+
+	private:
+		std::ostringstream _calls;
+	};
+
+	std::string streamed(const std::string& text) {
+		Recorder recorder;
+		sw::io::CommandParser parser = recorder.parser();
+		return recorder.result([&] {
+			std::istringstream stream(text);
+			parser.parse(stream, Commands{}, recorder);
+		});
+	}
+
+	std::string chunked(const std::string& text, size_t threads, size_t chunkBytes) {
+		Recorder recorder;
+		sw::io::CommandParser parser = recorder.parser();
+		return recorder.result([&] { parser.parse(std::string_view(text), Commands{}, recorder, threads, chunkBytes); });
+	}
+
+	// Команды всех видов вперемешку с комментариями, пустыми строками, \r и ошибочными полями.
+	// error: 0 — без ошибки, 1 — неизвестная команда, 2 — исключение handler
+	std::string scenario(std::mt19937& random, size_t lines, int error) {
+		std::ostringstream out;
+		const size_t errorLine = error == 0 ? lines : random() % lines;
+		for (size_t line = 0; line < lines; ++line) {
+			if (line == errorLine) {
+				if (error == 1)
+					out << "SPAWN_DRAGON 1 2 3\n";
+				else
+					out << "MARCH " << kRejectedUnit << " 1 1\n";
+				continue;
+			}
+			switch (random() % 8) {
+				case 0: out << "CREATE_MAP " << random() % 100 << ' ' << random() % 100 << '\n'; break;
+				case 1: out << "SPAWN_SWORDSMAN " << line << ' ' << random() % 10 << ' ' << random() % 10 << " 5 2\r\n"; break;
+				case 2: out << "SPAWN_HUNTER " << line << " 1 2 3 4 5 6\n"; break;
+				case 3: out << "MARCH " << line << " -1 4294967296\n"; break;
+				case 4: out << "// comment " << line << '\n'; break;
+				case 5: out << "\n   \t\n"; break;
+				case 6: out << "  SPAWN_SWORDSMAN\t" << line << " 12abc\n"; break;
+				default: out << "MARCH " << line << ' ' << random() % 10 << " 7"; if (line + 1 < lines) out << '\n'; break;
+			}
+		}
+		return out.str();
+	}
+}
+
+int main() {
+	std::mt19937 random(8);
+	for (int i = 0; i < 60; ++i) {
+		const int error = i % 3;
+		const std::string text = scenario(random, 20 + random() % 300, error);
+		const std::string expected = streamed(text);
+		check((expected.find("error: ") != std::string::npos) == (error != 0), "scenario " + std::to_string(i) + " fails only when it should");
+		for (size_t threads : {size_t{1}, size_t{2}, size_t{3}, size_t{8}}) {
+			for (size_t chunkBytes : {size_t{0}, size_t{1}, size_t{17}, size_t{256}, text.size(), sw::io::CommandParser::kDefaultParseChunkBytes}) {
+				check(chunked(text, threads, chunkBytes) == expected,
+					"scenario " + std::to_string(i) + " with " + std::to_string(threads) + " threads and " + std::to_string(chunkBytes) + "-byte chunks");
+			}
+		}
+	}
+
+	if (failures > 0) {
+		std::cerr << failures << " checks failed\n";
+		return 1;
+	}
+	std::cout << "OK\n";
+	return 0;
+}
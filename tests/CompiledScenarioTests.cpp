@@ -0,0 +1,164 @@
+// Поврежденный или обрезанный двоичный сценарий отклоняется исключением, без чтения за пределами буфера;
+// строй, не прошедший бы проверку compile, отклоняется до создания юнитов
+#include <IO/Commands/CreateMap.hpp>
+#include <IO/Commands/March.hpp>
+#include <IO/Commands/SpawnHunter.hpp>
+#include <IO/Commands/SpawnHunterFormation.hpp>
+#include <IO/Commands/SpawnSwordsman.hpp>
+#include <IO/Commands/SpawnSwordsmanFormation.hpp>
+#include <IO/System/CompiledScenario.hpp>
+#include <SimulationRunner.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+
+	int failures = 0;
+
+	void check(bool condition, const std::string& what) {
+		if (condition)
+			return;
+		++failures;
+		std::cerr << "FAILED: " << what << '\n';
+	}
+
+	using Commands = sw::io::CommandList<sw::io::CreateMap, sw::io::SpawnHunterFormation, sw::io::March>;
+
+	std::vector<std::byte> compiled() {
+		sw::io::CompiledScenarioWriter<Commands> writer;
+		writer.add(sw::io::CreateMap{20, 20});
+		writer.add(sw::io::SpawnHunterFormation{1, 2, 2, 3, 2, 1, 10, 2, 1, 4});
+		writer.add(sw::io::March{1, 15, 15});
+		std::ostringstream out;
+		writer.write(out);
+		const std::string text = out.str();
+		std::vector<std::byte> bytes(text.size());
+		std::memcpy(bytes.data(), text.data(), text.size());
+		return bytes;
+	}
+
+	// Копия в отдельном буфере точного размера: чтение за его конец видно санитайзеру
+	size_t read(const std::vector<std::byte>& bytes, size_t size) {
+		const auto buffer = std::make_unique<std::byte[]>(size);
+		std::memcpy(buffer.get(), bytes.data(), size);
+		size_t commands = 0;
+		sw::io::readCompiledScenario(buffer.get(), size, Commands{}, [&](auto) { ++commands; });
+		return commands;
+	}
+
+	bool rejected(const std::vector<std::byte>& bytes, size_t size) {
+		try {
+			read(bytes, size);
+		} catch (const std::runtime_error&) {
+			return true;
+		}
+		return false;
+	}
+
+	// Порядок команд двоичного сценария SimulationRunner
+	using RunnerCommands = sw::io::CommandList<
+		sw::io::CreateMap,
+		sw::io::SpawnSwordsman,
+		sw::io::SpawnHunter,
+		sw::io::March,
+		sw::io::SpawnSwordsmanFormation,
+		sw::io::SpawnHunterFormation>;
+
+	// Сценарий с картой 20 x 20 и одним строем, записанный в обход проверок compile
+	template <class TFormation>
+	std::string withFormation(const TFormation& formation) {
+		sw::io::CompiledScenarioWriter<RunnerCommands> writer;
+		writer.add(sw::io::CreateMap{20, 20});
+		writer.add(formation);
+		std::ostringstream out;
+		writer.write(out);
+		return out.str();
+	}
+
+	// Сообщение исключения loadCompiled (пустое, если сценарий принят) и лог событий
+	std::pair<std::string, std::string> loadCompiled(const std::string& scenario) {
+		std::ostringstream events;
+		std::string error;
+		{
+			sw::SimulationRunner runner(events);
+			try {
+				runner.loadCompiled(reinterpret_cast<const std::byte*>(scenario.data()), scenario.size());
+			} catch (const std::runtime_error& e) {
+				error = e.what();
+			}
+		}
+		return {error, events.str()};
+	}
+
+	// Заголовок на одну запись и запись с номером типа tag, объявленной длиной length и fields байтами полей
+	std::vector<std::byte> singleRecord(uint32_t commandTypes, uint8_t tag, uint32_t length, size_t fields) {
+		sw::io::CompiledScenarioHeader header;
+		std::memcpy(header.magic, sw::io::CompiledScenarioHeader::kMagic, sizeof(header.magic));
+		header.version = sw::io::CompiledScenarioHeader::kVersion;
+		header.commandTypes = commandTypes;
+		header.recordCount = 1;
+		std::vector<std::byte> bytes(sizeof(header) + sizeof(tag) + sizeof(length) + fields);
+		std::memcpy(bytes.data(), &header, sizeof(header));
+		std::memcpy(bytes.data() + sizeof(header), &tag, sizeof(tag));
+		std::memcpy(bytes.data() + sizeof(header) + sizeof(tag), &length, sizeof(length));
+		return bytes;
+	}
+}
+
+int main() {
+	const std::vector<std::byte> bytes = compiled();
+	check(read(bytes, bytes.size()) == 3, "intact scenario yields every command");
+	for (size_t size = 0; size < bytes.size(); ++size)
+		check(rejected(bytes, size), "truncated to " + std::to_string(size) + " bytes");
+
+	// Длина формации меньше ее полей: байты после записи есть, но читать их нельзя
+	const size_t formationFields = 10 * sizeof(uint32_t);
+	for (uint32_t length : {0u, 4u, 39u})
+		check(rejected(singleRecord(3, 1, length, formationFields), singleRecord(3, 1, length, formationFields).size()),
+			"formation record declaring " + std::to_string(length) + " bytes");
+	check(rejected(singleRecord(3, 1, 44, 44), sizeof(sw::io::CompiledScenarioHeader) + 5 + 44), "formation record with extra bytes");
+	check(!rejected(singleRecord(3, 1, 40, 40), sizeof(sw::io::CompiledScenarioHeader) + 5 + 40), "formation record of exact length");
+
+	// Запись SPAWN_HUNTER_FORMATION длиной 0 в конце файла, через SimulationRunner
+	const std::vector<std::byte> truncatedFormation = singleRecord(6, 5, 0, 0);
+	bool runnerRejected = false;
+	try {
+		std::ostringstream events;
+		sw::SimulationRunner runner(events);
+		runner.loadCompiled(truncatedFormation.data(), truncatedFormation.size());
+	} catch (const std::runtime_error&) {
+		runnerRejected = true;
+	}
+	check(runnerRejected, "runner rejects a zero-length formation record");
+
+	// Целые записи строя, которые compile не пропустил бы: отклоняются до создания юнитов
+	check(loadCompiled(withFormation(sw::io::SpawnSwordsmanFormation{1, 2, 2, 3, 2, 1, 10, 2})).first.empty(), "valid formation is accepted");
+	const std::vector<std::pair<std::string, std::string>> invalid{
+		{withFormation(sw::io::SpawnSwordsmanFormation{1, 15, 2, 10, 1, 1, 10, 2}), "formation is out of map bounds"},
+		{withFormation(sw::io::SpawnHunterFormation{1, 2, 2, 3, 3, 9, 10, 2, 1, 4}), "formation is out of map bounds"},
+		{withFormation(sw::io::SpawnSwordsmanFormation{4294967295u, 2, 2, 2, 1, 1, 10, 2}), "unit ids overflow"},
+		{withFormation(sw::io::SpawnHunterFormation{1, 2, 2, 3, 2, 0, 10, 2, 1, 4}), "spacing must be positive"},
+		{withFormation(sw::io::SpawnSwordsmanFormation{1, 2, 2, 0, 2, 1, 10, 2}), "formation cannot be empty"},
+	};
+	for (const auto& [scenario, message] : invalid) {
+		const auto [error, events] = loadCompiled(scenario);
+		check(error.find(message) != std::string::npos, "compiled formation rejected with '" + message + "', got '" + error + "'");
+		check(events.find("UNIT_SPAWNED") == std::string::npos, "rejected formation '" + message + "' spawns nobody");
+	}
+
+	if (failures > 0) {
+		std::cerr << failures << " checks failed\n";
+		return 1;
+	}
+	std::cout << "OK\n";
+	return 0;
+}
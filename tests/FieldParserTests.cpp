@@ -0,0 +1,146 @@
+// Разбор полей команды из строки (StringViewParserVisitor) совпадает с разбором operator>> (CommandParserVisitor):
+// минус у беззнаковых по модулю, насыщение при переполнении, после первой ошибки остальные поля не меняются
+#include <IO/System/details/CommandParserVisitor.hpp>
+#include <IO/System/details/StringViewParserVisitor.hpp>
+
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+
+	int failures = 0;
+
+	void check(bool condition, const std::string& what) {
+		if (condition)
+			return;
+		++failures;
+		std::cerr << "FAILED: " << what << '\n';
+	}
+
+	// Поля всех разрешенных типов; начальные значения видно, если поле не тронуто
+	struct Fields {
+		uint32_t first = 11;
+		uint32_t second = 22;
+		int32_t signedValue = -33;
+		uint64_t wide = 44;
+		int64_t signedWide = -55;
+		std::string word = "untouched";
+		uint32_t last = 66;
+
+		template <typename Visitor>
+		void visit(Visitor& visitor) {
+			visitor.visit("first", first);
+			visitor.visit("second", second);
+			visitor.visit("signedValue", signedValue);
+			visitor.visit("wide", wide);
+			visitor.visit("signedWide", signedWide);
+			visitor.visit("word", word);
+			visitor.visit("last", last);
+		}
+
+		bool operator==(const Fields&) const = default;
+
+		std::string text() const {
+			std::ostringstream out;
+			out << first << ' ' << second << ' ' << signedValue << ' ' << wide << ' ' << signedWide << " '" << word << "' " << last;
+			return out.str();
+		}
+	};
+
+	// Одно поле каждого типа в начале строки, остальные — как в Fields
+	template <class TField>
+	struct Single {
+		TField value{77};
+		uint32_t next = 88;
+
+		template <typename Visitor>
+		void visit(Visitor& visitor) {
+			visitor.visit("value", value);
+			visitor.visit("next", next);
+		}
+
+		bool operator==(const Single&) const = default;
+
+		std::string text() const {
+			return std::to_string(value) + ' ' + std::to_string(next);
+		}
+	};
+
+	template <class TFields>
+	void compare(std::string_view line) {
+		TFields expected;
+		std::istringstream stream{std::string(line)};
+		sw::CommandParserVisitor streamVisitor(stream);
+		expected.visit(streamVisitor);
+
+		TFields actual;
+		sw::StringViewParserVisitor viewVisitor(line);
+		actual.visit(viewVisitor);
+
+		check(actual == expected, "'" + std::string(line) + "': expected " + expected.text() + ", got " + actual.text());
+	}
+
+	template <class TField>
+	void compareSingle(std::string_view number) {
+		for (const std::string& suffix : {std::string(" 5"), std::string(""), std::string("\r"), std::string("x 5")})
+			compare<Single<TField>>(std::string(number) + suffix);
+	}
+}
+
+int main() {
+	const std::vector<std::string> numbers{
+		"0", "-0", "+0", "+", "-", "7", "+7", "-7", "-1",
+		"2147483647", "2147483648", "-2147483648", "-2147483649",
+		"4294967295", "4294967296", "-4294967295", "-4294967296", "99999999999",
+		"9223372036854775807", "9223372036854775808", "-9223372036854775808", "-9223372036854775809",
+		"18446744073709551615", "18446744073709551616", "-18446744073709551615", "-18446744073709551616",
+		"000000000000000000000000000042", "12abc", "abc", "--1", "+-1", "1-", "",
+	};
+	for (const std::string& number : numbers) {
+		compareSingle<uint32_t>(number);
+		compareSingle<int32_t>(number);
+		compareSingle<uint64_t>(number);
+		compareSingle<int64_t>(number);
+	}
+
+	// Строки целиком: пробелы любого вида, \r в конце, ошибка в середине и обрыв строки
+	for (const char* line : {
+			 "1 2 3 4 5 word 6",
+			 "  1\t2  -3 4 -5 word 6\r",
+			 "1 2 3 4 5 word 6\r\n",
+			 "1 -2 3 4 5 word",
+			 "1 2 3",
+			 "1 4294967296 3 4 5 word 6",
+			 "1 2 -2147483649 4 5 word 6",
+			 "12abc 2 3 4 5 word 6",
+			 "1 + 3 4 5 word 6",
+			 "1 2 3 -1 -1 word -1",
+			 "1 2 3 4 5",
+			 "1 2 3 4 5 \r",
+			 "",
+			 "\r",
+		 })
+		compare<Fields>(line);
+
+	// Случайные строки из цифр, знаков, пробелов и букв
+	std::mt19937 random(1);
+	const std::string alphabet = "0123456789000999-+ \t\r\nab";
+	for (int i = 0; i < 20000; ++i) {
+		std::string line(random() % 40, ' ');
+		for (char& c : line)
+			c = alphabet[random() % alphabet.size()];
+		compare<Fields>(line);
+	}
+
+	if (failures > 0) {
+		std::cerr << failures << " checks failed\n";
+		return 1;
+	}
+	std::cout << "OK\n";
+	return 0;
+}
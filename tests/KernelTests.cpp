@@ -0,0 +1,295 @@
+// Скалярные и AVX2-версии ядер должны давать одинаковый результат, а запросы занятости GridMap —
+// совпадать с перебором клеток. Без AVX2 на процессоре векторные версии не вызываются
+#include <Core/BitCount.hpp>
+#include <Core/CpuFeatures.hpp>
+#include <Core/DistanceKernel.hpp>
+#include <Core/GridMap.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+
+	int failures = 0;
+
+	void check(bool condition, const std::string& what) {
+		if (condition)
+			return;
+		++failures;
+		std::cerr << "FAILED: " << what << '\n';
+	}
+
+	std::string describe(size_t count, const sw::core::Coord& center, int32_t minD, int32_t maxD) {
+		return "count=" + std::to_string(count) + " center=(" + std::to_string(center.x) + "," + std::to_string(center.y) + ") minD="
+			+ std::to_string(minD) + " maxD=" + std::to_string(maxD);
+	}
+
+	// hits дописываются к уже заполненному вектору: ядро не должно трогать прежние элементы
+	void compareRing(const std::vector<int32_t>& xs, const std::vector<int32_t>& ys, const sw::core::Coord& center, int32_t minD, int32_t maxD) {
+		namespace kernels = sw::core::kernels;
+		std::vector<uint32_t> scalar{7, 7};
+		std::vector<uint32_t> dispatched{7, 7};
+		kernels::chebyshevRingScalar(xs.data(), ys.data(), xs.size(), center, minD, maxD, scalar);
+		kernels::chebyshevRing(xs.data(), ys.data(), xs.size(), center, minD, maxD, dispatched);
+		check(scalar == dispatched, "chebyshevRing " + describe(xs.size(), center, minD, maxD));
+		if (sw::core::cpuHasAvx2()) {
+			std::vector<uint32_t> avx2{7, 7};
+			kernels::chebyshevRingAvx2(xs.data(), ys.data(), xs.size(), center, minD, maxD, avx2);
+			check(scalar == avx2, "chebyshevRingAvx2 " + describe(xs.size(), center, minD, maxD));
+		}
+	}
+
+	void testChebyshevRing(std::mt19937& random) {
+		constexpr int32_t kMin = std::numeric_limits<int32_t>::min();
+		constexpr int32_t kMax = std::numeric_limits<int32_t>::max();
+		const std::vector<int32_t> extremes{kMin, kMin + 1, -1, 0, 1, kMax - 1, kMax};
+		const std::vector<sw::core::Coord> centers{{0, 0}, {5, 5}, {-3, 7}, {kMax, kMax}, {kMin, kMin}, {kMax, kMin}, {0, kMax}};
+		const std::vector<std::pair<int32_t, int32_t>> rings{{0, 0}, {0, 1}, {1, 1}, {2, 5}, {0, 16}, {-4, 3}, {3, 2}, {0, -1}, {5, kMax}, {0, kMax}};
+
+		// Хвосты любой длины после блоков по 8, координаты около центра
+		std::uniform_int_distribution<int32_t> near(-20, 20);
+		for (size_t count = 0; count <= 40; ++count) {
+			std::vector<int32_t> xs(count);
+			std::vector<int32_t> ys(count);
+			for (size_t i = 0; i < count; ++i) {
+				xs[i] = near(random);
+				ys[i] = near(random);
+			}
+			for (const auto& [minD, maxD] : rings)
+				compareRing(xs, ys, sw::core::Coord{0, 0}, minD, maxD);
+		}
+
+		// Отрицательные и крайние координаты, удаленные слоты (kRemovedCoord), крайние центры
+		std::uniform_int_distribution<size_t> pick(0, extremes.size() - 1);
+		std::uniform_int_distribution<int32_t> any(kMin, kMax);
+		for (int round = 0; round < 200; ++round) {
+			const size_t count = static_cast<size_t>(random() % 70);
+			std::vector<int32_t> xs(count);
+			std::vector<int32_t> ys(count);
+			for (size_t i = 0; i < count; ++i) {
+				switch (random() % 4) {
+				case 0:
+					xs[i] = sw::core::kernels::kRemovedCoord;
+					ys[i] = sw::core::kernels::kRemovedCoord;
+					break;
+				case 1:
+					xs[i] = extremes[pick(random)];
+					ys[i] = extremes[pick(random)];
+					break;
+				case 2:
+					xs[i] = any(random);
+					ys[i] = any(random);
+					break;
+				default:
+					xs[i] = near(random);
+					ys[i] = near(random);
+					break;
+				}
+			}
+			for (const sw::core::Coord& center : centers) {
+				for (const auto& [minD, maxD] : rings)
+					compareRing(xs, ys, center, minD, maxD);
+			}
+			compareRing(xs, ys, sw::core::Coord{any(random), any(random)}, 0, any(random));
+		}
+	}
+
+	void testPopcount(std::mt19937_64& random) {
+		namespace bits = sw::core::bits;
+		// Запас слов перед началом, чтобы проверять невыровненные начала
+		constexpr size_t kMaxWords = 130;
+		std::vector<uint64_t> words(kMaxWords + 4);
+		for (int round = 0; round < 4; ++round) {
+			for (uint64_t& word : words) {
+				switch (round) {
+				case 0:
+					word = random();
+					break;
+				case 1:
+					word = ~uint64_t{0};
+					break;
+				case 2:
+					word = 0;
+					break;
+				default:
+					word = random() & random() & random();
+					break;
+				}
+			}
+			for (size_t offset = 0; offset < 4; ++offset) {
+				for (size_t count = 0; count <= kMaxWords; ++count) {
+					const uint64_t* data = words.data() + offset;
+					const size_t expected = bits::popcountScalar(data, count);
+					const std::string what = " round=" + std::to_string(round) + " offset=" + std::to_string(offset) + " count=" + std::to_string(count);
+					check(bits::popcount(data, count) == expected, "popcount" + what);
+					if (sw::core::cpuHasAvx2())
+						check(bits::popcountAvx2(data, count) == expected, "popcountAvx2" + what);
+				}
+			}
+		}
+	}
+
+	// Карта и ее копия для перебора: занятость по всем клеткам
+	class ReferenceMap {
+	public:
+		ReferenceMap(uint32_t width, uint32_t height, sw::core::CellLayout layout)
+			: map(width, height, layout)
+			, _width(static_cast<int32_t>(width))
+			, _height(static_cast<int32_t>(height))
+			, _cells(static_cast<size_t>(width) * height, false)
+		{}
+
+		void set(const sw::core::Coord& c, bool occupied) {
+			if (occupied)
+				map.setOccupied(c, 1);
+			else
+				map.clear(c);
+			_cells[index(c)] = occupied;
+		}
+
+		bool occupied(int64_t x, int64_t y) const {
+			return x >= 0 && y >= 0 && x < _width && y < _height && _cells[static_cast<size_t>(y * _width + x)];
+		}
+
+		bool anyAround(const sw::core::Coord& center) const {
+			for (int64_t y = int64_t{center.y} - 1; y <= int64_t{center.y} + 1; ++y) {
+				for (int64_t x = int64_t{center.x} - 1; x <= int64_t{center.x} + 1; ++x) {
+					if ((x != center.x || y != center.y) && occupied(x, y))
+						return true;
+				}
+			}
+			return false;
+		}
+
+		size_t inRect(const sw::core::Coord& min, const sw::core::Coord& max) const {
+			size_t total = 0;
+			for (int64_t y = std::max<int64_t>(min.y, 0); y <= std::min<int64_t>(max.y, _height - 1); ++y) {
+				for (int64_t x = std::max<int64_t>(min.x, 0); x <= std::min<int64_t>(max.x, _width - 1); ++x)
+					total += occupied(x, y) ? 1 : 0;
+			}
+			return total;
+		}
+
+		std::set<std::pair<int32_t, int32_t>> inRing(const sw::core::Coord& center, int32_t minD, int32_t maxD) const {
+			std::set<std::pair<int32_t, int32_t>> cells;
+			for (int32_t y = 0; y < _height; ++y) {
+				for (int32_t x = 0; x < _width; ++x) {
+					const int32_t d = sw::core::chebyshevDistance(sw::core::Coord{x, y}, center);
+					if (d >= minD && d <= maxD && occupied(x, y))
+						cells.emplace(x, y);
+				}
+			}
+			return cells;
+		}
+
+		sw::core::GridMap map;
+
+	private:
+		size_t index(const sw::core::Coord& c) const {
+			return static_cast<size_t>(c.y) * static_cast<size_t>(_width) + static_cast<size_t>(c.x);
+		}
+
+		int32_t _width;
+		int32_t _height;
+		std::vector<bool> _cells;
+	};
+
+	// Координаты у границ тайлов и карты (и за ней) по одной оси
+	std::vector<int32_t> edgeCoords(int32_t size) {
+		std::vector<int32_t> coords{-2, -1, 0, 1, size - 2, size - 1, size, size + 1};
+		for (int32_t edge = sw::core::GridMap::kTileSize; edge < size; edge += sw::core::GridMap::kTileSize) {
+			for (int32_t d = -2; d <= 1; ++d)
+				coords.push_back(edge + d);
+		}
+		return coords;
+	}
+
+	void testGridMapQueries(std::mt19937& random) {
+		const std::string layoutNames[] = {"RowMajor", "Morton"};
+		// Карта не кратна тайлу: крайние тайлы неполные
+		for (const auto& [width, height] : {std::pair<uint32_t, uint32_t>{150, 131}, std::pair<uint32_t, uint32_t>{64, 64}}) {
+			for (sw::core::CellLayout layout : {sw::core::CellLayout::RowMajor, sw::core::CellLayout::Morton}) {
+				// Плотности от пустой карты до сплошной; затем часть клеток освобождается (тайлы возвращаются)
+				for (uint32_t density : {0u, 3u, 50u, 97u, 100u}) {
+					ReferenceMap ref(width, height, layout);
+					std::uniform_int_distribution<uint32_t> percent(0, 99);
+					for (int32_t y = 0; y < static_cast<int32_t>(height); ++y) {
+						for (int32_t x = 0; x < static_cast<int32_t>(width); ++x) {
+							if (percent(random) < density)
+								ref.set(sw::core::Coord{x, y}, true);
+						}
+					}
+					for (int32_t y = 0; y < static_cast<int32_t>(height); y += 2) {
+						for (int32_t x = 0; x < 64 && x < static_cast<int32_t>(width); ++x)
+							ref.set(sw::core::Coord{x, y}, false);
+					}
+
+					const std::string what = " " + std::to_string(width) + "x" + std::to_string(height) + " "
+						+ layoutNames[layout == sw::core::CellLayout::Morton ? 1 : 0] + " density=" + std::to_string(density);
+					const std::vector<int32_t> xs = edgeCoords(static_cast<int32_t>(width));
+					const std::vector<int32_t> ys = edgeCoords(static_cast<int32_t>(height));
+					for (int32_t y : ys) {
+						for (int32_t x : xs) {
+							const sw::core::Coord center{x, y};
+							const std::string at = what + " center=(" + std::to_string(x) + "," + std::to_string(y) + ")";
+							check(ref.map.anyOccupiedAround(center) == ref.anyAround(center), "anyOccupiedAround" + at);
+							for (int32_t radius : {0, 1, 2, 63, 64, 65}) {
+								const sw::core::Coord min{x - radius, y - radius};
+								const sw::core::Coord max{x + radius, y + radius};
+								check(ref.map.occupiedInRect(min, max) == ref.inRect(min, max), "occupiedInRect r=" + std::to_string(radius) + at);
+							}
+						}
+					}
+
+					// Прямоугольники произвольных размеров, в том числе целые тайлы и вылезающие за карту
+					std::uniform_int_distribution<int32_t> coordX(-70, static_cast<int32_t>(width) + 70);
+					std::uniform_int_distribution<int32_t> coordY(-70, static_cast<int32_t>(height) + 70);
+					for (int round = 0; round < 300; ++round) {
+						sw::core::Coord a{coordX(random), coordY(random)};
+						sw::core::Coord b{coordX(random), coordY(random)};
+						check(ref.map.occupiedInRect(a, b) == ref.inRect(a, b), "occupiedInRect random" + what);
+					}
+					check(ref.map.occupiedInRect(sw::core::Coord{0, 0}, sw::core::Coord{63, 63}) == ref.inRect(sw::core::Coord{0, 0}, sw::core::Coord{63, 63}), "occupiedInRect whole tile" + what);
+
+					// Кольца: число занятых и набор клеток, перечисленных nthOccupiedInRing
+					for (const sw::core::Coord center : {sw::core::Coord{0, 0}, sw::core::Coord{63, 64}, sw::core::Coord{static_cast<int32_t>(width) - 1, 5}}) {
+						for (const auto& [minD, maxD] : {std::pair<int32_t, int32_t>{1, 1}, {2, 4}, {0, 70}, {60, 66}}) {
+							const auto expected = ref.inRing(center, minD, maxD);
+							const std::string ring = what + " ring " + std::to_string(minD) + ".." + std::to_string(maxD);
+							check(ref.map.occupiedInRing(center, minD, maxD) == expected.size(), "occupiedInRing" + ring);
+							std::set<std::pair<int32_t, int32_t>> listed;
+							for (size_t n = 0; n < expected.size(); ++n) {
+								if (const auto cell = ref.map.nthOccupiedInRing(center, minD, maxD, n))
+									listed.emplace(cell->x, cell->y);
+							}
+							check(listed == expected, "nthOccupiedInRing" + ring);
+						}
+					}
+				}
+			}
+		}
+	}
+}
+
+int main() {
+	std::mt19937 random(12345);
+	std::mt19937_64 random64(54321);
+	if (!sw::core::cpuHasAvx2())
+		std::cout << "AVX2 is not supported: only dispatch is checked\n";
+	testChebyshevRing(random);
+	testPopcount(random64);
+	testGridMapQueries(random);
+	if (failures > 0) {
+		std::cerr << failures << " checks failed\n";
+		return 1;
+	}
+	std::cout << "OK\n";
+	return 0;
+}
@@ -0,0 +1,258 @@
+// Пропуск ходов марша (World::planMarchSkip) не меняет лога: SimulationRunner сравнивается с ходами по одному
+// через core::takeTurns, как в SimulationRunner::advanceTick до пропуска
+#include <Core/GridMap.hpp>
+#include <Core/Perception.hpp>
+#include <Core/RandomSource.hpp>
+#include <Core/StateCycleDetector.hpp>
+#include <Core/TurnLoop.hpp>
+#include <Core/World.hpp>
+#include <Features/UnitFactory.hpp>
+#include <IO/Events/UnitDied.hpp>
+#include <IO/System/EventLog.hpp>
+#include <SimulationRunner.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <optional>
+#include <random>
+#include <set>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+
+	int failures = 0;
+
+	void check(bool condition, const std::string& what) {
+		if (condition)
+			return;
+		++failures;
+		std::cerr << "FAILED: " << what << '\n';
+	}
+
+	struct Spawn {
+		bool hunter{};
+		uint32_t id{};
+		sw::core::Coord position{};
+		uint32_t hp{};
+		uint32_t agility{};
+		uint32_t strength{};
+		uint32_t range{};
+		std::optional<sw::core::Coord> march;
+	};
+
+	struct Scenario {
+		uint32_t width{};
+		uint32_t height{};
+		uint64_t tickCap = sw::SimulationRunner::kDefaultTickCap;
+		std::vector<Spawn> spawns;
+
+		std::string text() const {
+			std::ostringstream out;
+			out << "CREATE_MAP " << width << ' ' << height << '\n';
+			for (const Spawn& spawn : spawns) {
+				if (spawn.hunter)
+					out << "SPAWN_HUNTER " << spawn.id << ' ' << spawn.position.x << ' ' << spawn.position.y << ' ' << spawn.hp << ' ' << spawn.agility << ' ' << spawn.strength << ' ' << spawn.range << '\n';
+				else
+					out << "SPAWN_SWORDSMAN " << spawn.id << ' ' << spawn.position.x << ' ' << spawn.position.y << ' ' << spawn.hp << ' ' << spawn.strength << '\n';
+				if (spawn.march)
+					out << "MARCH " << spawn.id << ' ' << spawn.march->x << ' ' << spawn.march->y << '\n';
+			}
+			return out.str();
+		}
+	};
+
+	// Лог ходов (без событий загрузки сценария на ходу 1), номер последнего хода, причина остановки
+	// и хеш итогового состояния мира (в нем и цели марша, которых нет в логе)
+	std::string withSkip(const Scenario& scenario) {
+		std::srand(5);
+		std::ostringstream events;
+		std::string summary;
+		{
+			sw::SimulationRunner runner(events);
+			runner.setTickCap(scenario.tickCap);
+			runner.load(std::string_view(scenario.text()));
+			runner.simulate();
+			summary = "ticks=" + std::to_string(runner.tick()) + " reason=" + sw::terminationReasonName(runner.terminationReason())
+					+ " hash=" + std::to_string(runner.world().stateHash()) + '\n';
+		}
+		std::istringstream lines(events.str());
+		std::string result;
+		for (std::string line; std::getline(lines, line);) {
+			if (line.rfind("[1] ", 0) != 0)
+				result += line + '\n';
+		}
+		return result + summary;
+	}
+
+	std::string turnByTurn(const Scenario& scenario) {
+		using namespace sw;
+		std::srand(5);
+		core::World world(core::GridMap{scenario.width, scenario.height});
+		for (const Spawn& spawn : scenario.spawns) {
+			if (spawn.hunter) {
+				world.spawn(features::createHunter(world.pool(), spawn.id, spawn.position, static_cast<int32_t>(spawn.hp), static_cast<int32_t>(spawn.agility), static_cast<int32_t>(spawn.strength), static_cast<int32_t>(spawn.range)));
+			} else {
+				world.spawn(features::createSwordsman(world.pool(), spawn.id, spawn.position, static_cast<int32_t>(spawn.hp), static_cast<int32_t>(spawn.strength)));
+			}
+			if (spawn.march)
+				world.setUnitMarchTarget(spawn.id, *spawn.march);
+		}
+
+		std::ostringstream events;
+		uint64_t tick = 1;
+		TerminationReason reason = TerminationReason::LastUnitStanding;
+		{
+			EventLog log(events);
+			core::Perception perception;
+			core::RandomSource random;
+			core::StateCycleDetector seenStates;
+			seenStates.seen(world.stateHash());
+			bool finished = world.aliveUnitsCount() <= 1 || tick >= scenario.tickCap;
+			if (finished)
+				reason = world.aliveUnitsCount() > 1 ? TerminationReason::TickCap : TerminationReason::LastUnitStanding;
+			while (!finished) {
+				++tick;
+				const bool anyActed = core::takeTurns(world, log, tick, perception, random, [](const core::Unit&) {});
+				for (uint32_t id : world.removeDeadUnits())
+					log.log(tick, io::UnitDied{id});
+				if (!anyActed) {
+					reason = TerminationReason::NoActions;
+					finished = true;
+				} else if (seenStates.seen(world.stateHash())) {
+					reason = TerminationReason::RepeatedState;
+					finished = true;
+				} else if (world.aliveUnitsCount() <= 1 || tick >= scenario.tickCap) {
+					reason = world.aliveUnitsCount() > 1 ? TerminationReason::TickCap : TerminationReason::LastUnitStanding;
+					finished = true;
+				}
+			}
+		}
+		return events.str() + "ticks=" + std::to_string(tick) + " reason=" + terminationReasonName(reason)
+			 + " hash=" + std::to_string(world.stateHash()) + '\n';
+	}
+
+	class Builder {
+	public:
+		Builder(uint32_t width, uint32_t height, std::mt19937& random)
+			: _random(random)
+		{
+			_scenario.width = width;
+			_scenario.height = height;
+		}
+
+		uint32_t coordinate(uint32_t size) {
+			return std::uniform_int_distribution<uint32_t>(0, size - 1)(_random);
+		}
+
+		uint32_t number(uint32_t from, uint32_t to) {
+			return std::uniform_int_distribution<uint32_t>(from, to)(_random);
+		}
+
+		sw::core::Coord anyCell() {
+			return sw::core::Coord{static_cast<int32_t>(coordinate(_scenario.width)), static_cast<int32_t>(coordinate(_scenario.height))};
+		}
+
+		bool add(Spawn spawn) {
+			const sw::core::Coord& c = spawn.position;
+			if (c.x < 0 || c.y < 0 || c.x >= static_cast<int32_t>(_scenario.width) || c.y >= static_cast<int32_t>(_scenario.height))
+				return false;
+			if (!_occupied.emplace(c.x, c.y).second)
+				return false;
+			spawn.id = _nextId++;
+			_scenario.spawns.push_back(spawn);
+			return true;
+		}
+
+		Spawn fighter(sw::core::Coord position) {
+			Spawn spawn;
+			spawn.hunter = number(0, 2) == 0;
+			spawn.position = position;
+			// Юнит с нулевым hp погибает в конце первого хода, даже если идет один
+			spawn.hp = number(0, 12);
+			spawn.agility = number(0, 3);
+			spawn.strength = number(0, 3);
+			spawn.range = number(2, 7);
+			return spawn;
+		}
+
+		Scenario& scenario() {
+			return _scenario;
+		}
+
+	private:
+		std::mt19937& _random;
+		Scenario _scenario;
+		std::set<std::pair<int32_t, int32_t>> _occupied;
+		uint32_t _nextId = 1;
+	};
+
+	// Отряды на открытом поле: марширующие идут жадными шагами, стоящие засыпают и просыпаются от подошедших
+	Scenario openField(std::mt19937& random) {
+		const uint32_t size = std::uniform_int_distribution<uint32_t>(20, 150)(random);
+		Builder builder(size, size, random);
+		const uint32_t units = builder.number(2, 30);
+		for (uint32_t i = 0; i < units; ++i) {
+			Spawn spawn = builder.fighter(builder.anyCell());
+			if (builder.number(0, 3) != 0)
+				spawn.march = builder.anyCell();
+			builder.add(spawn);
+		}
+		if (builder.number(0, 2) == 0)
+			builder.scenario().tickCap = builder.number(2, 60);
+		return builder.scenario();
+	}
+
+	// Стена из юнитов с нулевым hp погибает в конце первого хода. Марширующие вплотную к ней успевают
+	// проложить путь A* в обход и дальше идут по сохраненному пути
+	Scenario fallenWall(std::mt19937& random) {
+		Builder builder(std::uniform_int_distribution<uint32_t>(40, 160)(random), 60, random);
+		const int32_t x = static_cast<int32_t>(builder.number(10, builder.scenario().width - 10));
+		const int32_t top = static_cast<int32_t>(builder.number(0, 20));
+		const int32_t bottom = static_cast<int32_t>(builder.number(40, 59));
+		for (int32_t y = top; y <= bottom; ++y)
+			builder.add(Spawn{true, 0, sw::core::Coord{x, y}, 0, 0, 0, 2, std::nullopt});
+		const uint32_t marchers = builder.number(1, 6);
+		for (uint32_t i = 0; i < marchers; ++i) {
+			const int32_t side = builder.number(0, 1) == 0 ? -1 : 1;
+			Spawn spawn = builder.fighter(sw::core::Coord{x - side, static_cast<int32_t>(builder.number(top, bottom))});
+			spawn.hp += 5;
+			const int32_t targetX = std::clamp<int32_t>(x + side * static_cast<int32_t>(builder.number(3, 40)), 0, static_cast<int32_t>(builder.scenario().width) - 1);
+			spawn.march = sw::core::Coord{targetX, static_cast<int32_t>(builder.coordinate(60))};
+			builder.add(spawn);
+		}
+		return builder.scenario();
+	}
+}
+
+int main() {
+	std::mt19937 random(3);
+	for (int i = 0; i < 150; ++i) {
+		const Scenario scenario = openField(random);
+		check(withSkip(scenario) == turnByTurn(scenario), "open field scenario " + std::to_string(i) + ":\n" + scenario.text());
+	}
+	for (int i = 0; i < 100; ++i) {
+		const Scenario scenario = fallenWall(random);
+		check(withSkip(scenario) == turnByTurn(scenario), "fallen wall scenario " + std::to_string(i) + ":\n" + scenario.text());
+	}
+
+	// Все идут, но юнит с нулевым hp должен погибнуть в конце первого хода
+	Scenario doomed;
+	doomed.width = 100;
+	doomed.height = 100;
+	doomed.spawns.push_back(Spawn{false, 1, sw::core::Coord{0, 0}, 5, 0, 1, 0, sw::core::Coord{40, 90}});
+	doomed.spawns.push_back(Spawn{false, 2, sw::core::Coord{99, 0}, 0, 0, 1, 0, sw::core::Coord{60, 90}});
+	doomed.spawns.push_back(Spawn{true, 3, sw::core::Coord{50, 0}, 5, 1, 1, 3, sw::core::Coord{50, 90}});
+	check(withSkip(doomed) == turnByTurn(doomed), "marcher with zero hp dies after the first turn");
+
+	if (failures > 0) {
+		std::cerr << failures << " checks failed\n";
+		return 1;
+	}
+	std::cout << "OK\n";
+	return 0;
+}
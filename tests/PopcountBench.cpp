@@ -0,0 +1,44 @@
+// Сравнение скалярного и AVX2 popcount на массивах разной длины; в сборку по умолчанию не входит:
+//   cmake --build <каталог сборки> --target sw_popcount_bench
+#include <Core/BitCount.hpp>
+#include <Core/CpuFeatures.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace {
+
+	// Наносекунд на вызов; сумма возвращается, чтобы вызовы не выбросил оптимизатор
+	template <class F>
+	double measure(F&& popcount, const std::vector<uint64_t>& words, size_t& sink) {
+		const size_t calls = std::max<size_t>(1, (size_t{1} << 26) / std::max<size_t>(words.size(), 1));
+		const auto start = std::chrono::steady_clock::now();
+		for (size_t i = 0; i < calls; ++i)
+			sink += popcount(words.data(), words.size());
+		const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+		return elapsed.count() / static_cast<double>(calls);
+	}
+}
+
+int main() {
+	namespace bits = sw::core::bits;
+	std::mt19937_64 random(1);
+	size_t sink = 0;
+	std::cout << "words scalar_ns avx2_ns dispatch_ns\n";
+	for (size_t count : {1, 4, 8, 16, 64, 256, 1024, 16384}) {
+		std::vector<uint64_t> words(count);
+		for (uint64_t& word : words)
+			word = random();
+		std::cout << count << ' ' << measure(bits::popcountScalar, words, sink) << ' ';
+		if (sw::core::cpuHasAvx2())
+			std::cout << measure(bits::popcountAvx2, words, sink);
+		else
+			std::cout << '-';
+		std::cout << ' ' << measure(bits::popcount, words, sink) << '\n';
+	}
+	return sink == 0 ? 1 : 0;
+}
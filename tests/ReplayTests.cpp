@@ -0,0 +1,100 @@
+// Индекс ключевых кадров не переиспользуется для другого лога и не ломает переход при повреждении
+#include <Replay/KeyframeIndex.hpp>
+#include <Replay/ReplayState.hpp>
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+
+namespace {
+
+	int failures = 0;
+
+	void check(bool condition, const std::string& what) {
+		if (condition)
+			return;
+		++failures;
+		std::cerr << "FAILED: " << what << '\n';
+	}
+
+	// Юнит идет по строке row: логи с разными row одного размера
+	std::string marchLog(uint32_t row) {
+		std::ostringstream log;
+		log << "[1] MAP_CREATED width=20 height=10 \n";
+		log << "[1] UNIT_SPAWNED unitId=1 unitType=Swordsman x=0 y=" << row << " \n";
+		log << "[1] MARCH_STARTED unitId=1 x=0 y=" << row << " targetX=9 targetY=" << row << " \n";
+		for (uint32_t tick = 2; tick <= 10; ++tick)
+			log << '[' << tick << "] UNIT_MOVED unitId=1 x=" << tick - 1 << " y=" << row << " \n";
+		return log.str();
+	}
+
+	void write(const std::filesystem::path& path, const std::string& text) {
+		std::ofstream(path, std::ios::binary | std::ios::trunc) << text;
+	}
+
+	std::string stateAt(const std::filesystem::path& log, uint64_t tick) {
+		std::ostringstream out;
+		sw::replay::printReplayState(out, sw::replay::seekReplay(log.string(), tick, 2));
+		return out.str();
+	}
+
+	// Состояние по логу без индекса
+	std::string freshStateAt(const std::filesystem::path& log, uint64_t tick) {
+		std::filesystem::remove(sw::replay::KeyframeIndex::indexPathFor(log.string()));
+		return stateAt(log, tick);
+	}
+}
+
+int main() {
+	const std::filesystem::path dir = std::filesystem::temp_directory_path() / ("sw_replay_tests_" + std::to_string(std::random_device{}()));
+	std::filesystem::create_directories(dir);
+	const std::filesystem::path log = dir / "battle.log";
+	const std::string index = sw::replay::KeyframeIndex::indexPathFor(log.string());
+
+	const std::string first = marchLog(3);
+	const std::string second = marchLog(7);
+	check(first.size() == second.size(), "logs of both battles have the same size");
+
+	write(log, second);
+	const std::string expected = freshStateAt(log, 5);
+	check(expected.find("y=7") != std::string::npos, "replayed state follows the log");
+
+	// Индекс первого боя при логе второго того же размера
+	write(log, first);
+	freshStateAt(log, 5);
+	check(std::filesystem::exists(index), "index is written");
+	write(log, second);
+	check(stateAt(log, 5) == expected, "index of another log of the same size is rebuilt");
+
+	// Поврежденный индекс: обрезан, неверное число кадров, кадр за пределами файла
+	freshStateAt(log, 5);
+	const auto indexSize = std::filesystem::file_size(index);
+	for (uintmax_t size = 0; size < indexSize; size += 7) {
+		freshStateAt(log, 5);
+		std::filesystem::resize_file(index, size);
+		check(stateAt(log, 5) == expected, "index truncated to " + std::to_string(size) + " bytes");
+	}
+	for (uint64_t value : {uint64_t{1} << 40, ~uint64_t{0}, uint64_t{1} << 60}) {
+		for (std::streamoff offset : {std::streamoff{8}, std::streamoff{16}, std::streamoff{24}, std::streamoff{40}}) {
+			freshStateAt(log, 5);
+			{
+				std::fstream patch(index, std::ios::binary | std::ios::in | std::ios::out);
+				patch.seekp(-offset, std::ios::end);
+				patch.write(reinterpret_cast<const char*>(&value), sizeof(value));
+			}
+			check(stateAt(log, 5) == expected, "index with corrupted table at -" + std::to_string(offset));
+		}
+	}
+
+	std::filesystem::remove_all(dir);
+	if (failures > 0) {
+		std::cerr << failures << " checks failed\n";
+		return 1;
+	}
+	std::cout << "OK\n";
+	return 0;
+}
@@ -0,0 +1,70 @@
+// Пропускная способность ядра кольца Чебышева (скалярное и AVX2) на миллионе позиций;
+// в сборку по умолчанию не входит:
+//   cmake --build <каталог сборки> --target sw_ring_bench
+#include <Core/CpuFeatures.hpp>
+#include <Core/DistanceKernel.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <utility>
+#include <vector>
+
+namespace {
+
+	constexpr size_t kUnits = 1'000'000;
+	constexpr int kRepeats = 20;
+
+	using Kernel = void (*)(const int32_t*, const int32_t*, size_t, const sw::core::Coord&, int32_t, int32_t, std::vector<uint32_t>&);
+
+	// Миллисекунд на проход по kUnits позициям (лучший из kRepeats); число попаданий возвращается в hits
+	double measure(Kernel kernel, const std::vector<int32_t>& xs, const std::vector<int32_t>& ys, int32_t minD, int32_t maxD, size_t& hits) {
+		std::vector<uint32_t> out;
+		out.reserve(xs.size());
+		double best = 0;
+		for (int repeat = 0; repeat < kRepeats; ++repeat) {
+			out.clear();
+			const auto start = std::chrono::steady_clock::now();
+			kernel(xs.data(), ys.data(), xs.size(), sw::core::Coord{0, 0}, minD, maxD, out);
+			const std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+			if (repeat == 0 || elapsed.count() < best)
+				best = elapsed.count();
+		}
+		hits = out.size();
+		return best;
+	}
+}
+
+int main() {
+	namespace kernels = sw::core::kernels;
+	// Позиции в квадрате 2000 x 2000 вокруг центра; кольца с разной долей попаданий
+	std::mt19937 random(1);
+	std::uniform_int_distribution<int32_t> coord(-1000, 1000);
+	std::vector<int32_t> xs(kUnits);
+	std::vector<int32_t> ys(kUnits);
+	for (size_t i = 0; i < kUnits; ++i) {
+		xs[i] = coord(random);
+		ys[i] = coord(random);
+	}
+
+	std::cout << "units=" << kUnits << (sw::core::cpuHasAvx2() ? "" : " (AVX2 is not supported)") << '\n';
+	std::cout << "ring hits scalar_ms avx2_ms scalar_munits_per_s avx2_munits_per_s\n";
+	for (const auto& [minD, maxD] : {std::pair<int32_t, int32_t>{2, 8}, {0, 100}, {100, 500}, {0, 1000}}) {
+		size_t hits = 0;
+		const double scalar = measure(&kernels::chebyshevRingScalar, xs, ys, minD, maxD, hits);
+		std::cout << minD << ".." << maxD << ' ' << hits << ' ' << scalar << ' ';
+		if (sw::core::cpuHasAvx2()) {
+			size_t avx2Hits = 0;
+			const double avx2 = measure(&kernels::chebyshevRingAvx2, xs, ys, minD, maxD, avx2Hits);
+			if (avx2Hits != hits) {
+				std::cerr << "AVX2 kernel disagrees with scalar\n";
+				return 1;
+			}
+			std::cout << avx2 << ' ' << kUnits / 1000.0 / scalar << ' ' << kUnits / 1000.0 / avx2 << '\n';
+		} else {
+			std::cout << "- " << kUnits / 1000.0 / scalar << " -\n";
+		}
+	}
+	return 0;
+}
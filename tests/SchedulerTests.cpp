@@ -0,0 +1,90 @@
+// Много коротких боев на двух потоках: wait возвращается, а лог каждого боя полон и совпадает с боем,
+// сыгранным отдельно с тем же ключом случайных выборов
+#include <Host/BattleScheduler.hpp>
+#include <SimulationRunner.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+	int failures = 0;
+
+	void check(bool condition, const std::string& what) {
+		if (condition)
+			return;
+		++failures;
+		std::cerr << "FAILED: " << what << '\n';
+	}
+
+	constexpr uint64_t kRandomSeed = 11;
+
+	// У охотников несколько целей в кольце, выбор случайный: без своего источника случайных чисел бои влияли бы друг на друга
+	std::string scenario(size_t battle) {
+		std::ostringstream out;
+		out << "CREATE_MAP 12 12\n";
+		out << "SPAWN_SWORDSMAN 1 2 2 " << 6 + battle % 5 << " 2\n";
+		out << "SPAWN_SWORDSMAN 2 4 2 7 1\n";
+		out << "SPAWN_SWORDSMAN 3 2 4 6 1\n";
+		out << "SPAWN_HUNTER 4 7 7 5 2 1 " << 5 + battle % 3 << '\n';
+		out << "SPAWN_HUNTER 5 8 3 4 1 1 6\n";
+		out << "MARCH 1 8 8\n";
+		out << "MARCH 2 " << battle % 12 << " 11\n";
+			return out.str();
+	}
+
+	std::unique_ptr<sw::SimulationRunner> load(size_t battle, std::ostream& events) {
+		auto runner = std::make_unique<sw::SimulationRunner>(events);
+		runner->load(std::string_view(scenario(battle)));
+		return runner;
+	}
+
+	// Лог боя, сыгранного отдельно на этом потоке
+	std::string alone(size_t battle, sw::host::BattleScheduler::BattleId id) {
+		std::ostringstream events;
+		{
+			auto runner = load(battle, events);
+			runner->setRandomKey(sw::host::BattleScheduler::randomKey(kRandomSeed, id));
+			runner->simulate();
+		}
+		return events.str();
+	}
+}
+
+int main() {
+	constexpr size_t kRounds = 20;
+	constexpr size_t kBattlesPerRound = 50;
+
+	// Потоки событий переживают бои: лог закрывается в деструкторе SimulationRunner
+	std::vector<std::unique_ptr<std::ostringstream>> events;
+	sw::host::BattleScheduler scheduler(2, kRandomSeed);
+	for (size_t round = 0; round < kRounds; ++round) {
+		// По одному ходу за квант: бои постоянно возвращаются в очередь, пока другой поток ждет
+		const size_t first = events.size();
+		for (size_t battle = first; battle < first + kBattlesPerRound; ++battle) {
+			events.push_back(std::make_unique<std::ostringstream>());
+			check(scheduler.add(load(battle, *events.back()), 1) == battle, "battle ids follow add order");
+		}
+		scheduler.wait();
+
+		for (size_t battle = first; battle < events.size(); ++battle) {
+			const sw::SimulationRunner& runner = scheduler.battle(battle);
+			check(runner.finished(), "battle " + std::to_string(battle) + " is finished after wait");
+			check(!scheduler.error(battle), "battle " + std::to_string(battle) + " did not throw");
+			check(events[battle]->str() == alone(battle, battle), "battle " + std::to_string(battle) + " log is complete");
+		}
+	}
+	check(scheduler.battleCount() == kRounds * kBattlesPerRound, "every battle is kept");
+
+	if (failures > 0) {
+		std::cerr << failures << " checks failed\n";
+		return 1;
+	}
+	std::cout << "OK\n";
+	return 0;
+}
@@ -0,0 +1,188 @@
+// Лог боя с шардированием не зависит от числа потоков и от чтения мира между ходами;
+// константные world и summary не собирают шарды, это делает явный gather
+#include <Core/GridMap.hpp>
+#include <Core/Perception.hpp>
+#include <Core/RandomSource.hpp>
+#include <Core/TurnLoop.hpp>
+#include <Core/Unit.hpp>
+#include <Core/World.hpp>
+#include <Features/Behaviors/MoveBehavior.hpp>
+#include <IO/System/EventLog.hpp>
+#include <Shard/ShardedTicks.hpp>
+#include <SimulationRunner.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+namespace {
+
+	int failures = 0;
+
+	void check(bool condition, const std::string& what) {
+		if (condition)
+			return;
+		++failures;
+		std::cerr << "FAILED: " << what << '\n';
+	}
+
+	// Несколько удаленных друг от друга арен. В каждой — стычка мечников и охотников и мечники, идущие внутрь
+	// кольца из охотников
+	std::string scenario() {
+		std::ostringstream out;
+		out << "CREATE_MAP 460 120\n";
+		uint32_t id = 1;
+		for (uint32_t arena = 0; arena < 6; ++arena) {
+			const uint32_t x0 = 10 + arena * 75;
+			const uint32_t y0 = 20 + (arena % 2) * 50;
+			for (uint32_t i = 0; i < 4; ++i) {
+				out << "SPAWN_SWORDSMAN " << id++ << ' ' << x0 + i << ' ' << y0 << " 12 " << 1 + i % 3 << '\n';
+				out << "SPAWN_HUNTER " << id++ << ' ' << x0 + i << ' ' << y0 + 3 << " 10 2 1 4\n";
+			}
+			// Кольцо охотников без урона вокруг клетки (x0 + 12, y0 + 12)
+			for (int32_t dy = -1; dy <= 1; ++dy) {
+				for (int32_t dx = -1; dx <= 1; ++dx) {
+					if (dx != 0 || dy != 0)
+						out << "SPAWN_HUNTER " << id++ << ' ' << x0 + 12 + dx << ' ' << y0 + 12 + dy << " 5 0 0 2\n";
+				}
+			}
+			for (uint32_t i = 0; i < 2; ++i) {
+				out << "SPAWN_SWORDSMAN " << id << ' ' << x0 + 2 + 4 * i << ' ' << y0 + 20 << " 8 1\n";
+				out << "MARCH " << id++ << ' ' << x0 + 12 << ' ' << y0 + 12 << '\n';
+			}
+		}
+		return out.str();
+	}
+
+	// Как читается мир между ходами
+	enum class Read {
+		Never,
+		// gather, затем world
+		Gathered,
+		// world и summary без gather: константные методы бросают исключение, не трогая шардов
+		Ungathered,
+	};
+
+	bool throws(const std::function<void()>& read) {
+		try {
+			read();
+		} catch (const std::runtime_error&) {
+			return true;
+		}
+		return false;
+	}
+
+	std::string run(size_t shardThreads, Read read = Read::Never) {
+		std::srand(7);
+		std::ostringstream events;
+		sw::SimulationRunner runner(events);
+		runner.setShardThreads(shardThreads);
+		runner.setTickCap(300);
+		runner.load(std::string_view(scenario()));
+		// По одному ходу за вызов, как у BattleScheduler: между вызовами юниты остаются в шардах
+		size_t rejectedReads = 0;
+		while (runner.step(1) > 0) {
+			if (read == Read::Gathered) {
+				runner.gather();
+				runner.world().aliveUnitsCount();
+			} else if (read == Read::Ungathered) {
+				const sw::SimulationRunner& view = runner;
+				const bool rejected = throws([&] { view.world(); });
+				check(rejected == throws([&] { view.summary(); }), "world and summary agree on whether shards are gathered");
+				rejectedReads += rejected;
+			}
+		}
+		if (read == Read::Ungathered)
+			check(rejectedReads > 0, "reading the world between sharded ticks requires gather");
+		events << "ticks=" << runner.tick() << " reason=" << sw::terminationReasonName(runner.terminationReason()) << '\n';
+		return events.str();
+	}
+
+	// Мечник или охотник рядом с занятой клеткой атакует, а не ищет путь, поэтому A* проверяется на юните только
+	// с движением. Его цель внутри кольца камней (юнитов без поведений): поиск обходит всю карту, и исход
+	// решает далекая группа камней. С ней свободных клеток не больше бюджета поиска — цель недостижима,
+	// юнит стоит. Без нее бюджет исчерпан — юнит делает любой свободный шаг
+	std::string walkAroundRing(size_t shardThreads) {
+		using namespace sw;
+		constexpr uint32_t kSide = 130;
+		static_assert(kSide * kSide > features::kDefaultPathSearchBudget + 9);
+		static_assert(kSide * kSide - 30 * 20 <= features::kDefaultPathSearchBudget + 9);
+
+		core::World world(core::GridMap(kSide, kSide));
+		uint32_t id = 1;
+		auto rock = [&](int32_t x, int32_t y) {
+			world.spawn(world.pool().make<core::Unit>(id++, "Rock", core::Coord{x, y}, 1, true));
+		};
+		auto walker = world.pool().make<core::Unit>(id++, "Walker", core::Coord{1, 1}, 1, true);
+		walker->addBehavior(world.pool().make<features::MoveBehavior>(1));
+		world.spawn(std::move(walker));
+		world.setUnitMarchTarget(1, core::Coord{5, 5});
+		for (int32_t dy = -1; dy <= 1; ++dy) {
+			for (int32_t dx = -1; dx <= 1; ++dx) {
+				if (dx != 0 || dy != 0)
+					rock(5 + dx, 5 + dy);
+			}
+		}
+		for (int32_t y = 80; y < 100; ++y) {
+			for (int32_t x = 80; x < 110; ++x)
+				rock(x, y);
+		}
+
+		std::ostringstream events;
+		{
+			EventLog log(events);
+			core::Perception perception;
+			core::RandomSource random(1);
+			std::unique_ptr<shard::ShardedTicks> shards;
+			if (shardThreads > 0)
+				shards = std::make_unique<shard::ShardedTicks>(shardThreads, 1);
+			for (uint64_t tick = 1; tick <= 2 * shard::ShardedTicks::kEpochTicks + 4; ++tick) {
+				if (shards)
+					shards->prepare(world, log, tick);
+				if (shards && shards->active()) {
+					shards->advance(tick, log);
+				} else {
+					check(!shards, "walker and rocks are split into shards");
+					core::takeTurns(world, log, tick, perception, random, [](const core::Unit&) {});
+				}
+			}
+			if (shards)
+				shards->dissolve(world);
+		}
+		const std::optional<core::Coord> position = world.getUnitPosition(1);
+		events << "walker at " << position->x << ' ' << position->y << '\n';
+		return events.str();
+	}
+}
+
+int main() {
+	const std::string single = run(1);
+	check(single.find("UNIT_DIED") != std::string::npos, "scenario has deaths");
+	// Бой длится несколько разбиений
+	check(single.find("\n[" + std::to_string(2 * sw::shard::ShardedTicks::kEpochTicks + 1) + "] ") != std::string::npos, "scenario outlasts two epochs");
+	check(run(2) == single, "2 threads match 1 thread");
+	check(run(4) == single, "4 threads match 1 thread");
+	check(run(4, Read::Gathered) == single, "gathering the world between ticks does not change the log");
+	check(run(4, Read::Ungathered) == single, "const reads between ticks do not change the log");
+
+	// Ни случайных выборов, ни боя: шардированный ход совпадает с обычным
+	const std::string unsharded = walkAroundRing(0);
+	check(unsharded.find("UNIT_MOVED") != std::string::npos, "walker reaches the ring");
+	check(walkAroundRing(1) == unsharded, "1 thread sees the far rocks");
+	check(walkAroundRing(2) == unsharded, "2 threads see the far rocks");
+	check(walkAroundRing(4) == unsharded, "4 threads see the far rocks");
+	if (failures > 0) {
+		std::cerr << failures << " checks failed\n";
+		return 1;
+	}
+	std::cout << "OK\n";
+	return 0;
+}